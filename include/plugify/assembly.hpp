@@ -4,10 +4,19 @@
 #include <plugify/load_flag.hpp>
 #include <plugify/mem_addr.hpp>
 #include <plugify_export.h>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace plugify {
+	class Pattern;
+	class ScanCache;
+	class VirtualTableIndex;
+
 	/**
 	 * @class Assembly
 	 * @brief Represents an assembly (module) within a process.
@@ -44,10 +53,93 @@ namespace plugify {
 			size_t size;        //!< The size of the section.
 		};
 
+		/**
+		 * @struct ParallelScan
+		 * @brief Execution policy which scans large sections on several threads.
+		 */
+		struct ParallelScan {
+			size_t threadCount{0}; //!< The number of threads, 0 uses the number of hardware threads.
+		};
+
+		/**
+		 * @class PatternRange
+		 * @brief Lazy range over every match of a pattern, the pattern is compiled once for the whole range.
+		 *
+		 * Matches may overlap, each one is searched for when the iterator is advanced. The range has to outlive its iterators.
+		 */
+		class PatternRange {
+		public:
+			/**
+			 * @class Iterator
+			 * @brief Forward iterator over the matches, equal to end() after the last one.
+			 */
+			class Iterator {
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = MemAddr;
+				using difference_type = std::ptrdiff_t;
+				using pointer = const MemAddr*;
+				using reference = MemAddr;
+
+				Iterator() = default;
+
+				MemAddr operator*() const noexcept { return _current; }
+
+				/**
+				 * @brief Moves to the next match.
+				 * @return The iterator itself.
+				 */
+				Iterator& operator++();
+
+				Iterator operator++(int) {
+					Iterator copy = *this;
+					++*this;
+					return copy;
+				}
+
+				bool operator==(const Iterator& other) const noexcept { return _current == other._current; }
+
+			private:
+				friend class PatternRange;
+
+				Iterator(const PatternRange* range, const uint8_t* current) noexcept : _range{range}, _current{current} {}
+
+				const PatternRange* _range{nullptr};
+				const uint8_t* _current{nullptr};
+			};
+
+			PatternRange() noexcept;
+			~PatternRange();
+
+			PatternRange(PatternRange&& other) noexcept;
+			PatternRange& operator=(PatternRange&& other) noexcept;
+
+			/**
+			 * @brief Searches for the first match.
+			 * @return The iterator to the first match, or end() if there is none.
+			 */
+			[[nodiscard]] Iterator begin() const;
+
+			/**
+			 * @brief Returns the past-the-last iterator.
+			 * @return The end iterator.
+			 */
+			[[nodiscard]] Iterator end() const noexcept { return {}; }
+
+		private:
+			friend class Assembly;
+
+			PatternRange(std::unique_ptr<Pattern> pattern, const uint8_t* begin, const uint8_t* end) noexcept;
+
+			std::unique_ptr<Pattern> _pattern; //!< The compiled pattern, null for an empty range.
+			const uint8_t* _begin{nullptr};    //!< The first byte of the scanned range.
+			const uint8_t* _end{nullptr};      //!< The byte after the scanned range.
+		};
+
 		/**
 		 * @brief Default constructor initializing handle to nullptr.
 		 */
-		Assembly() : _handle{nullptr} {}
+		Assembly();
 
 		/**
 		 * @brief Destructor.
@@ -71,7 +163,7 @@ namespace plugify {
 		 * @param moduleName The name of the module.
 		 * @param flags Optional flags for module initialization.
 		 * @param additionalSearchDirectories Optional additional search directories.
-		 * @param sections Optional flag indicating if sections should be initialized.
+		 * @param sections Optional flag indicating if sections should be initialized. On Linux they are read on first use.
 		 */
 		explicit Assembly(std::string_view moduleName, LoadFlag flags = LoadFlag::Default, const SearchDirs& additionalSearchDirectories = {}, bool sections = false);
 
@@ -80,7 +172,7 @@ namespace plugify {
 		 * @param moduleName The name of the module as a char pointer.
 		 * @param flags Optional flags for module initialization.
 		 * @param additionalSearchDirectories Optional additional search directories.
-		 * @param sections Optional flag indicating if sections should be initialized.
+		 * @param sections Optional flag indicating if sections should be initialized. On Linux they are read on first use.
 		 */
 		explicit Assembly(const char* moduleName, LoadFlag flags = LoadFlag::Default, const SearchDirs& additionalSearchDirectories = {}, bool sections = false)
 			: Assembly(std::string_view(moduleName), flags, additionalSearchDirectories, sections) {}
@@ -90,7 +182,7 @@ namespace plugify {
 		 * @param moduleName The name of the module as a string.
 		 * @param flags Optional flags for module initialization.
 		 * @param additionalSearchDirectories Optional additional search directories.
-		 * @param sections Optional flag indicating if sections should be initialized.
+		 * @param sections Optional flag indicating if sections should be initialized. On Linux they are read on first use.
 		 */
 		explicit Assembly(const std::string& moduleName, LoadFlag flags = LoadFlag::Default, const SearchDirs& additionalSearchDirectories = {}, bool sections = false)
 			: Assembly(std::string_view(moduleName), flags, additionalSearchDirectories, sections) {}
@@ -100,7 +192,7 @@ namespace plugify {
 		 * @param modulePath The filesystem path of the module.
 		 * @param flags Optional flags for module initialization.
 		 * @param additionalSearchDirectories Optional additional search directories.
-		 * @param sections Optional flag indicating if sections should be initialized.
+		 * @param sections Optional flag indicating if sections should be initialized. On Linux they are read on first use.
 		 */
 		explicit Assembly(const std::filesystem::path& modulePath, LoadFlag flags = LoadFlag::Default, const SearchDirs& additionalSearchDirectories = {}, bool sections = false);
 
@@ -109,7 +201,7 @@ namespace plugify {
 		 * @param moduleMemory The memory address of the module.
 		 * @param flags Optional flags for module initialization.
 		 * @param additionalSearchDirectories Optional additional search directories.
-		 * @param sections Optional flag indicating if sections should be initialized.
+		 * @param sections Optional flag indicating if sections should be initialized. On Linux they are read on first use.
 		 */
 		explicit Assembly(MemAddr moduleMemory, LoadFlag flags = LoadFlag::Default, const SearchDirs& additionalSearchDirectories = {}, bool sections = false);
 
@@ -139,6 +231,97 @@ namespace plugify {
 		 */
 		[[nodiscard]] MemAddr FindPattern(std::string_view pattern, MemAddr startAddress = nullptr, Section* moduleSection = nullptr) const;
 
+		/**
+		 * @brief Finds an array of bytes in process memory, scanning chunks of the section on several threads.
+		 *
+		 * The section is split into chunks which overlap by the pattern length minus one. Chunks are handed out in
+		 * address order and the ones after a chunk with a match are not scanned, so the result is exactly the one of
+		 * the serial FindPattern. Small sections are scanned on the calling thread.
+		 *
+		 * @param policy The parallel execution policy.
+		 * @param pattern The byte pattern to search for.
+		 * @param mask The mask corresponding to the byte pattern.
+		 * @param startAddress The start address for the search.
+		 * @param moduleSection The module section to search within.
+		 * @return The memory address where the pattern is found, or nullptr if not found.
+		 */
+		[[nodiscard]] MemAddr FindPattern(const ParallelScan& policy, MemAddr pattern, std::string_view mask, MemAddr startAddress = nullptr, Section* moduleSection = nullptr) const;
+
+		/**
+		 * @brief Finds a string pattern in process memory, scanning chunks of the section on several threads.
+		 * @param policy The parallel execution policy.
+		 * @param pattern The string pattern to search for.
+		 * @param startAddress The start address for the search.
+		 * @param moduleSection The module section to search within.
+		 * @return The memory address where the pattern is found, or nullptr if not found.
+		 */
+		[[nodiscard]] MemAddr FindPattern(const ParallelScan& policy, std::string_view pattern, MemAddr startAddress = nullptr, Section* moduleSection = nullptr) const;
+
+		/**
+		 * @brief Finds every occurrence of an array of bytes in process memory, the matches are searched for lazily.
+		 * @param pattern The byte pattern to search for, copied into the range.
+		 * @param mask The mask corresponding to the byte pattern.
+		 * @param startAddress The start address for the search.
+		 * @param moduleSection The module section to search within.
+		 * @return The range of the matches in address order.
+		 */
+		[[nodiscard]] PatternRange FindAllPatterns(MemAddr pattern, std::string_view mask, MemAddr startAddress = nullptr, Section* moduleSection = nullptr) const;
+
+		/**
+		 * @brief Finds every occurrence of a string pattern in process memory, the matches are searched for lazily.
+		 * @param pattern The string pattern to search for.
+		 * @param startAddress The start address for the search.
+		 * @param moduleSection The module section to search within.
+		 * @return The range of the matches in address order.
+		 */
+		[[nodiscard]] PatternRange FindAllPatterns(std::string_view pattern, MemAddr startAddress = nullptr, Section* moduleSection = nullptr) const;
+
+		/**
+		 * @brief Counts the occurrences of an array of bytes in process memory.
+		 * @param pattern The byte pattern to search for.
+		 * @param mask The mask corresponding to the byte pattern.
+		 * @param limit The count at which the scan stops, 2 is enough to check that a signature is unique.
+		 * @param moduleSection The module section to search within.
+		 * @return The number of matches, at most limit.
+		 */
+		[[nodiscard]] size_t CountPattern(MemAddr pattern, std::string_view mask, size_t limit = SIZE_MAX, Section* moduleSection = nullptr) const;
+
+		/**
+		 * @brief Counts the occurrences of a string pattern in process memory.
+		 * @param pattern The string pattern to search for.
+		 * @param limit The count at which the scan stops, 2 is enough to check that a signature is unique.
+		 * @param moduleSection The module section to search within.
+		 * @return The number of matches, at most limit.
+		 */
+		[[nodiscard]] size_t CountPattern(std::string_view pattern, size_t limit = SIZE_MAX, Section* moduleSection = nullptr) const;
+
+		/**
+		 * @brief Finds several string patterns in process memory in a single pass.
+		 *
+		 * The section is scanned once for all patterns instead of once per pattern, which pays off when many
+		 * signatures are resolved at startup.
+		 *
+		 * @param patterns The string patterns to search for.
+		 * @param moduleSection The module section to search within.
+		 * @return The first memory address where each pattern is found, in the same order as the patterns, or nullptr for patterns which are not found.
+		 */
+		[[nodiscard]] std::vector<MemAddr> FindPatterns(std::span<const std::string_view> patterns, Section* moduleSection = nullptr) const;
+
+		/**
+		 * @brief Enables the on-disk cache of FindPattern, FindPatterns and GetVirtualTableByName results.
+		 *
+		 * Found addresses are stored per module binary as offsets from the module base, in a file named after the
+		 * build id of the module (ELF NT_GNU_BUILD_ID) or the hash of its file when it has none. A cached address
+		 * is checked against the pattern (or the virtual table) before it is returned, so a stale entry only costs
+		 * a regular scan. Lookups which find nothing are not cached.
+		 *
+		 * The directory is read once per assembly, on its first cached lookup. The cache is written back when the
+		 * assembly is destroyed.
+		 *
+		 * @param directory The directory for the cache files, an empty path disables the cache.
+		 */
+		static void SetScanCacheDirectory(std::filesystem::path directory);
+
 		/**
 		 * @brief Gets an address of a virtual method table by RTTI type descriptor name.
 		 * @param tableName The name of the virtual table.
@@ -154,6 +337,24 @@ namespace plugify {
 		 */
 		[[nodiscard]] MemAddr GetFunctionByName(std::string_view functionName) const noexcept;
 
+		/**
+		 * @brief Gets addresses of several functions by their names at once.
+		 *
+		 * On Linux the dynamic symbol table of the loaded image is read once per call and every name is looked up
+		 * through its GNU (or SysV) hash table. Names which are not defined by the module itself, or need the dynamic
+		 * linker to resolve them (TLS, IFUNC), fall back to GetFunctionByName. Other platforms always use GetFunctionByName.
+		 *
+		 * @param functionNames The names of the functions.
+		 * @return The memory addresses of the functions in the same order as the names, nullptr for names which are not found.
+		 */
+		[[nodiscard]] std::vector<MemAddr> GetFunctionsByName(std::span<const std::string_view> functionNames) const;
+
+		/**
+		 * @brief Returns the build id of the module.
+		 * @return The build id as a hex string (ELF NT_GNU_BUILD_ID), or an empty string if the module has none or the platform does not provide it.
+		 */
+		[[nodiscard]] std::string GetBuildId() const;
+
 		/**
 		 * @brief Gets a module section by name.
 		 * @param sectionName The name of the section (e.g., ".rdata", ".text").
@@ -236,12 +437,78 @@ namespace plugify {
 		 */
 		bool InitFromMemory(MemAddr moduleMemory, LoadFlag flags, const SearchDirs& additionalSearchDirectories, bool sections);
 
+		/**
+		 * @brief Resolves the range a pattern scan covers.
+		 * @param startAddress The start address for the search.
+		 * @param moduleSection The module section to search within, the executable code if null.
+		 * @return The first and past-the-last byte of the range, both null if the section is invalid or the start address is outside of it.
+		 */
+		std::pair<const uint8_t*, const uint8_t*> GetScanRange(MemAddr startAddress, const Section* moduleSection) const;
+
+		/**
+		 * @brief Looks a pattern up in the scan cache and scans for it on a miss, used by the FindPattern overloads.
+		 * @param pattern The byte pattern to search for.
+		 * @param mask The mask corresponding to the byte pattern.
+		 * @param startAddress The start address for the search.
+		 * @param moduleSection The module section to search within.
+		 * @param threadCount The number of threads for the scan, 1 scans on the calling thread.
+		 * @return The memory address where the pattern is found, or nullptr if not found.
+		 */
+		MemAddr LookupPattern(MemAddr pattern, std::string_view mask, MemAddr startAddress, const Section* moduleSection, size_t threadCount) const;
+
+		/**
+		 * @brief Scans for a pattern without the scan cache, used by FindPattern and the platform lookups.
+		 * @param pattern The byte pattern to search for.
+		 * @param mask The mask corresponding to the byte pattern.
+		 * @param startAddress The start address for the search.
+		 * @param moduleSection The module section to search within.
+		 * @param threadCount The number of threads for the scan, 1 scans on the calling thread.
+		 * @return The memory address where the pattern is found, or nullptr if not found.
+		 */
+		MemAddr ScanPattern(MemAddr pattern, std::string_view mask, MemAddr startAddress, const Section* moduleSection, size_t threadCount = 1) const;
+
+		/**
+		 * @brief Finds a virtual method table without the scan cache, implemented per platform.
+		 * @param tableName The name of the virtual table.
+		 * @param decorated Indicates whether the name is decorated.
+		 * @return The memory address of the virtual table, or nullptr if not found.
+		 */
+		MemAddr FindVirtualTable(std::string_view tableName, bool decorated) const;
+
+		/**
+		 * @brief Opens the scan cache of the module on first use.
+		 * @return The scan cache, or nullptr if it is disabled.
+		 */
+		ScanCache* GetScanCache() const;
+
+		/**
+		 * @brief Builds the index of the virtual tables of the module on first use, only on platforms with the Itanium C++ ABI.
+		 * @return The index, or nullptr if the sections holding the tables are missing.
+		 */
+		const VirtualTableIndex* GetVirtualTableIndex() const;
+
+		/**
+		 * @brief Makes sure the sections are loaded and sorted by name, runs once on the first section lookup.
+		 */
+		void InitSections() const;
+
+		/**
+		 * @brief Reads the section headers of the module, used by platforms which load sections lazily.
+		 */
+		void LoadSections() const;
+
 	private:
 		void* _handle;                //!< The handle to the module.
 		std::filesystem::path _path;  //!< The path of the module.
-		std::string _error;           //!< The error of the module.
-		Section _executableCode;      //!< The section representing executable code.
-		std::vector<Section> _sections; //!< A vector of sections in the module.
+		mutable std::string _error;   //!< The error of the module, also set when lazily read sections fail.
+		mutable Section _executableCode;      //!< The section representing executable code.
+		mutable std::vector<Section> _sections; //!< A vector of sections in the module, sorted by name.
+		mutable std::once_flag _sectionsFlag; //!< Guards the lazy loading of the sections.
+		bool _lazySections{ false };  //!< Indicates if the sections are still to be read by LoadSections.
+		mutable std::unique_ptr<ScanCache> _scanCache; //!< The scan cache, opened by GetScanCache.
+		mutable std::once_flag _scanCacheFlag; //!< Guards the opening of the scan cache.
+		mutable std::unique_ptr<VirtualTableIndex> _virtualTableIndex; //!< The virtual table index, built by GetVirtualTableIndex.
+		mutable std::once_flag _virtualTableIndexFlag; //!< Guards the building of the virtual table index.
 	};
 
 	/**
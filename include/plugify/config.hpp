@@ -16,5 +16,10 @@ namespace plugify {
 		Severity logSeverity{ Severity::Verbose }; ///< The severity level for logging.
 		std::set<std::string> repositories; ///< A collection of repository paths.
 		bool preferOwnSymbols; ///< Flag indicating if the modules should prefer its own symbols over shared symbols.
+		bool parallelLoad{ false }; ///< Flag indicating if independent plugins should be loaded and started concurrently.
+		bool packageCache{ false }; ///< Flag indicating if parsed descriptors and the plugin load order should be cached on disk between runs.
+		bool prefetchBinaries{ false }; ///< Flag indicating if module and plugin binaries should be read ahead into the page cache before they are loaded.
+		bool measurePageFaults{ false }; ///< Flag indicating if page faults taken while loading each language module and its plugins should be logged.
+		std::filesystem::path traceFile; ///< Path of the Chrome trace file with startup phases, tracing is disabled if empty.
 	};
 } // namespace plugify
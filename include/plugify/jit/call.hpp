@@ -3,7 +3,10 @@
 #include <asmjit/asmjit.h>
 #include <plugify/mem_addr.hpp>
 #include <plugify/method.hpp>
+#include <algorithm>
+#include <limits>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <memory>
 #include <vector>
@@ -38,29 +41,85 @@ namespace plugify{
 		~JitCall();
 
 		/**
-		 * @struct Parameters
+		 * @struct BasicParameters
 		 * @brief Structure to represent function parameters.
+		 * @details Arguments are stored inline, so a block of up to N arguments lives where the object lives,
+		 * usually on the caller's stack. A larger block moves to the heap.
+		 * @tparam N Number of arguments stored inline.
 		 */
-		struct Parameters {
+		template<size_t N>
+		struct BasicParameters {
 			typedef const uint64_t* Data;
-			
+
 			/**
 			 * @brief Constructor.
-			 * @param count Parameters count.
+			 * @param count Parameters count, used to reserve the storage. More arguments can be added.
 			 */
-			explicit Parameters(uint8_t count) {
-				arguments.reserve(count);
+			explicit BasicParameters(uint8_t count) {
+				if (count > kInline) {
+					_heap = std::make_unique_for_overwrite<uint64_t[]>(count);
+					_capacity = count;
+				}
+			}
+
+			/**
+			 * @brief Copy constructor, copies the added arguments into storage of the same capacity.
+			 * @param other Another instance of BasicParameters.
+			 */
+			BasicParameters(const BasicParameters& other) : _count{other._count}, _capacity{other._capacity} {
+				if (other._heap) {
+					_heap = std::make_unique_for_overwrite<uint64_t[]>(_capacity);
+				}
+				std::copy_n(other.GetDataPtr(), _count, GetStorage());
+			}
+
+			/**
+			 * @brief Move constructor, takes the heap block or copies the inline arguments.
+			 * @param other Another instance of BasicParameters, left empty.
+			 */
+			BasicParameters(BasicParameters&& other) noexcept : _heap{std::move(other._heap)}, _count{other._count}, _capacity{other._capacity} {
+				if (!_heap) {
+					std::copy_n(other._arguments, _count, _arguments);
+				}
+				other._count = 0;
+				other._capacity = kInline;
+			}
+
+			BasicParameters& operator=(const BasicParameters& other) {
+				if (this != &other) {
+					*this = BasicParameters(other);
+				}
+				return *this;
+			}
+
+			BasicParameters& operator=(BasicParameters&& other) noexcept {
+				if (this != &other) {
+					_heap = std::move(other._heap);
+					_count = other._count;
+					_capacity = other._capacity;
+					if (!_heap) {
+						std::copy_n(other._arguments, _count, _arguments);
+					}
+					other._count = 0;
+					other._capacity = kInline;
+				}
+				return *this;
 			}
 
 			/**
 			 * @brief Set the value of the argument at next available position.
+			 * @details Moves the arguments to a larger heap block when the storage is full.
 			 * @tparam T Type of the argument.
 			 * @param val Value to set.
 			 * @noreturn
 			 */
 			template<typename T>
 			void AddArgument(T val) {
-				uint64_t& arg = arguments.emplace_back(0);
+				if (_count == _capacity) {
+					Grow();
+				}
+				uint64_t& arg = GetStorage()[_count++];
+				arg = 0;
 				*(T*) &arg = val;
 			}
 
@@ -69,13 +128,50 @@ namespace plugify{
 			 * @return Pointer to the arguments storage.
 			 */
 			Data GetDataPtr() const noexcept {
-				return arguments.data();
+				// resolved on use instead of cached, so the block stays movable
+				return _heap ? _heap.get() : _arguments;
 			}
-			
+
+			/**
+			 * @brief Get the number of added arguments.
+			 * @return Number of arguments.
+			 */
+			size_t GetCount() const noexcept {
+				return _count;
+			}
+
 		private:
-			std::vector<uint64_t> arguments; ///< Raw storage for function arguments.
+			uint64_t* GetStorage() noexcept {
+				return _heap ? _heap.get() : _arguments;
+			}
+
+			void Grow() {
+				const size_t capacity = _capacity * 2;
+				auto heap = std::make_unique_for_overwrite<uint64_t[]>(capacity);
+				std::copy_n(GetDataPtr(), _count, heap.get());
+				_heap = std::move(heap);
+				_capacity = capacity;
+			}
+
+		private:
+			static constexpr size_t kInline = N ? N : 1;
+
+			uint64_t _arguments[kInline]; ///< Raw inline storage for function arguments.
+			std::unique_ptr<uint64_t[]> _heap; ///< Storage for blocks larger than N.
+			size_t _count{};
+			size_t _capacity{kInline}; ///< Number of arguments which fit the storage.
 		};
-		
+
+		/**
+		 * @brief Number of arguments Parameters stores without allocating.
+		 */
+		static constexpr size_t kInlineParameters = 16;
+
+		/**
+		 * @brief Parameters of a dynamic call, allocation-free for up to kInlineParameters arguments.
+		 */
+		using Parameters = BasicParameters<kInlineParameters>;
+
 		struct Return {
 			/**
 			 * @brief Constructs an object of type `T` at the memory location.
@@ -128,6 +224,21 @@ namespace plugify{
 		using CallingFunc = void(*)(Parameters::Data params, const Return*); // Return can be null
 		using HiddenParam = bool(*)(ValueType);
 
+		/**
+		 * @brief Call a generated function with arguments packed at compile time.
+		 * @details The arguments are written into an inline block sized from the signature, so the call
+		 * does not allocate. Methods with references take pointers, and a return passed as hidden argument
+		 * is called as void with the return pointer as the first argument, see GetSignature.
+		 * @tparam F Function type, like int(int, double).
+		 * @param function Function returned by GetJitFunc.
+		 * @param args Arguments, converted to the parameter types of F.
+		 * @return Value returned by the target.
+		 */
+		template<typename F, typename... Ts>
+		static decltype(auto) Invoke(MemAddr function, Ts&&... args) {
+			return Invoker<F>::Call(function, std::forward<Ts>(args)...);
+		}
+
 		/**
 		 * @brief Get a dynamically created function based on the raw signature. 
 		 * @param sig Function signature.
@@ -148,6 +259,27 @@ namespace plugify{
 		 */
 		MemAddr GetJitFunc(MethodRef method, MemAddr target, WaitType waitType = WaitType::None, HiddenParam hidden = &ValueUtils::IsHiddenParam);
 
+		/**
+		 * @brief Build the raw signature of the method.
+		 * @param method Reference to the method.
+		 * @param hidden Tells whether a return type is passed as hidden argument.
+		 * @param retHidden Receives whether the return is passed as hidden argument.
+		 * @return The signature.
+		 */
+		static asmjit::FuncSignature GetSignature(MethodRef method, HiddenParam hidden, bool& retHidden);
+
+		/**
+		 * @brief Emit the stub as a function of the compiler.
+		 * @param compiler Compiler of the target architecture.
+		 * @param sig Function signature.
+		 * @param target The target function address.
+		 * @param waitType Optionally insert a breakpoint before the call.
+		 * @param hidden If true, return will be pass as hidden argument.
+		 * @param error Receives the error message on failure.
+		 * @return Label of the stub, invalid on failure.
+		 */
+		static asmjit::Label EmitStub(asmjit::BaseCompiler& compiler, const asmjit::FuncSignature& sig, MemAddr target, WaitType waitType, bool hidden, const char*& error);
+
 		/**
 		 * @brief Get a dynamically created function.
 		 * @return Pointer to the already generated function.
@@ -169,6 +301,29 @@ namespace plugify{
 		 */
 		[[nodiscard]] std::string_view GetError() noexcept { return !_function && _errorCode ? _errorCode : ""; }
 
+	private:
+		template<typename F>
+		struct Invoker;
+
+		template<typename Ret, typename... Args>
+		struct Invoker<Ret(Args...)> {
+			static_assert(sizeof...(Args) <= std::numeric_limits<uint8_t>::max(), "Too many parameters");
+			static_assert(((sizeof(Args) <= sizeof(uint64_t) && std::is_trivially_copyable_v<Args>) && ...), "Parameters must fit a 64bit slot");
+
+			static Ret Call(MemAddr function, Args... args) {
+				BasicParameters<sizeof...(Args)> params(static_cast<uint8_t>(sizeof...(Args)));
+				(params.AddArgument(args), ...);
+				if constexpr (std::is_void_v<Ret>) {
+					function.RCast<CallingFunc>()(params.GetDataPtr(), nullptr);
+				} else {
+					static_assert(sizeof(Ret) <= sizeof(Return) && std::is_trivially_copyable_v<Ret>, "Return must fit the return storage");
+					Return ret;
+					function.RCast<CallingFunc>()(params.GetDataPtr(), &ret);
+					return ret.template GetReturn<Ret>();
+				}
+			}
+		};
+
 	private:
 		std::weak_ptr<asmjit::JitRuntime> _rt;
 		MemAddr _function;
@@ -4,6 +4,58 @@
 
 using namespace plugify;
 
+#if PLUGIFY_JIT_TAIL_STUBS
+namespace {
+	// A void target which takes every argument in a register needs no frame and no return marshalling:
+	// load the arguments at constant offsets and branch to the target, which returns straight to our caller.
+	// The link register and the stack are untouched, so nothing has to be restored.
+	// Emitted outside of a function node with physical registers, returns an invalid label if the full stub is needed.
+	asmjit::Label EmitTailStub(asmjit::a64::Compiler& cc, const asmjit::FuncSignature& sig, MemAddr target) {
+		if (sig.hasRet() || sig.hasVarArgs())
+			return {};
+
+		asmjit::FuncDetail self;
+		asmjit::FuncDetail detail;
+		if (self.init(asmjit::FuncSignature::build<void, JitCall::Parameters*, JitCall::Return*>(), cc.environment()) || detail.init(sig, cc.environment()))
+			return {};
+
+		for (uint32_t argIdx = 0; argIdx < sig.argCount(); ++argIdx) {
+			const auto& argType = sig.args()[argIdx];
+			if (!(asmjit::TypeUtils::isInt(argType) || asmjit::TypeUtils::isFloat(argType)) || !detail.arg(argIdx).isReg())
+				return {};
+		}
+
+		asmjit::Label label = cc.newLabel();
+		cc.bind(label);
+
+		// x16 (ip0) is not an argument register and is a valid br source for bti c
+		cc.mov(asmjit::a64::x16, target.GetPtr());
+
+		// the parameters pointer shares x0 with the first integer argument, load that one last
+		const uint32_t paramsId = self.arg(0).regId();
+		uint32_t lastIdx = asmjit::Globals::kInvalidId;
+		for (uint32_t argIdx = 0; argIdx < sig.argCount(); ++argIdx) {
+			const asmjit::FuncValue& arg = detail.arg(argIdx);
+			const asmjit::a64::Mem slot = asmjit::a64::ptr(asmjit::a64::x(paramsId), static_cast<int32_t>(argIdx * sizeof(uint64_t)));
+			if (asmjit::TypeUtils::isFloat(sig.args()[argIdx])) {
+				cc.ldr(asmjit::a64::d(arg.regId()), slot);
+			} else if (arg.regId() == paramsId) {
+				lastIdx = argIdx;
+			} else {
+				cc.ldr(asmjit::a64::x(arg.regId()), slot);
+			}
+		}
+		if (lastIdx != asmjit::Globals::kInvalidId) {
+			cc.ldr(asmjit::a64::x(paramsId), asmjit::a64::ptr(asmjit::a64::x(paramsId), static_cast<int32_t>(lastIdx * sizeof(uint64_t))));
+		}
+
+		cc.br(asmjit::a64::x16);
+
+		return label;
+	}
+}
+#endif // PLUGIFY_JIT_TAIL_STUBS
+
 JitCall::JitCall(std::weak_ptr<asmjit::JitRuntime> rt) : _rt{std::move(rt)} {
 }
 
@@ -36,15 +88,54 @@ MemAddr JitCall::GetJitFunc(const asmjit::FuncSignature& sig, MemAddr target, Wa
 	asmjit::CodeHolder code;
 	code.init(rt->environment(), rt->cpuFeatures());
 
-	// initialize function
 	asmjit::a64::Compiler cc(&code);
+	if (!EmitStub(cc, sig, target, waitType, hidden, _errorCode).isValid())
+		return nullptr;
+
+	// write to buffer
+	cc.finalize();
+
+	asmjit::Error err = rt->add(&_function, &code);
+	if (err) {
+		_function = nullptr;
+		_errorCode = asmjit::DebugUtils::errorAsString(err);
+		return nullptr;
+	}
+
+	//PL_LOG_VERBOSE("JIT Stub:\n{}", log.data());
+
+	return _function;
+}
+
+asmjit::Label JitCall::EmitStub(asmjit::BaseCompiler& compiler, const asmjit::FuncSignature& sig, MemAddr target, WaitType waitType, bool hidden, const char*& error) {
+	auto& cc = static_cast<asmjit::a64::Compiler&>(compiler);
+
+#if PLUGIFY_JIT_TAIL_STUBS
+	if (waitType == WaitType::None && !hidden) {
+		asmjit::Label tail = EmitTailStub(cc, sig, target);
+		if (tail.isValid())
+			return tail;
+	}
+#endif // PLUGIFY_JIT_TAIL_STUBS
+
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	// vectors passed by value are loaded through the pointer in their slot, one register per element
+	asmjit::FuncSignature callee;
+	std::vector<JitUtils::ArgPart> parts;
+	if (!JitUtils::ExpandSignature(sig, cc.environment(), callee, parts, error))
+		return {};
+#else
+	const asmjit::FuncSignature& callee = sig;
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
+
+	// initialize function
 	asmjit::FuncNode* func = cc.addFunc(asmjit::FuncSignature::build<void, Parameters*, Return*>());// Create the wrapper function around call we JIT
 
 	/*StringLogger log;
 	auto kFormatFlags = FormatFlags::kMachineCode | FormatFlags::kExplainImms | FormatFlags::kRegCasts | FormatFlags::kHexImms | FormatFlags::kHexOffsets | FormatFlags::kPositions;
 
 	log.addFlags(kFormatFlags);
-	code.setLogger(&log);*/
+	cc.code()->setLogger(&log);*/
 
 #if PLUGIFY_IS_RELEASE
 	// too small to really need it
@@ -57,6 +148,53 @@ MemAddr JitCall::GetJitFunc(const asmjit::FuncSignature& sig, MemAddr target, Wa
 	asmjit::a64::Gp returnImm = cc.newGpx();
 	func->setArg(1, returnImm);
 
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	// each argument has a fixed slot, so read it at a constant offset. The return address takes the first slot if hidden
+	const uint32_t firstSlot = hidden ? 1 : 0;
+
+	if (hidden) {
+		// load first arg and store its address to ret struct
+		asmjit::a64::Gp tmp = cc.newGpx();
+		cc.ldr(tmp, ptr(paramImm));
+		cc.str(tmp, ptr(returnImm));
+	}
+
+	std::vector<asmjit::a64::Reg> argRegisters;
+	argRegisters.reserve(parts.size());
+
+	asmjit::a64::Gp vectorPtr;
+	uint32_t vectorIdx = asmjit::Globals::kInvalidId;
+
+	// map argument slots to registers, following abi. (We can have multiple register per arg slot such as high and low 32bits of a 64bit slot)
+	for (const auto& part : parts) {
+		asmjit::a64::Mem paramMem = ptr(paramImm, static_cast<int32_t>((firstSlot + part.arg) * sizeof(uint64_t)));
+
+		if (part.size) {
+			// the slot of a vector holds a pointer to it
+			if (part.arg != vectorIdx) {
+				vectorPtr = cc.newGpx();
+				cc.ldr(vectorPtr, paramMem);
+				vectorIdx = part.arg;
+			}
+			paramMem = ptr(vectorPtr, static_cast<int32_t>(part.offset));
+		}
+
+		asmjit::a64::Reg arg;
+		if (asmjit::TypeUtils::isInt(part.type)) {
+			arg = cc.newGpx();
+			cc.ldr(arg.as<asmjit::a64::Gp>(), paramMem);
+		} else if (asmjit::TypeUtils::isFloat(part.type)) {
+			arg = cc.newVec(part.type);
+			cc.ldr(arg.as<asmjit::a64::Vec>(), paramMem);
+		} else {
+			// ex: void example(__m128i xmmreg) is invalid: https://github.com/asmjit/asmjit/issues/83
+			error = "Parameters wider than 64bits not supported";
+			return {};
+		}
+
+		argRegisters.push_back(std::move(arg));
+	}
+#else
 	// paramMem = ((char*)paramImm) + i (char* size walk, uint64_t size r/w)
 	asmjit::a64::Gp i = cc.newGpx();
 	asmjit::a64::Mem paramMem = ptr(paramImm, i);
@@ -91,8 +229,8 @@ MemAddr JitCall::GetJitFunc(const asmjit::FuncSignature& sig, MemAddr target, Wa
 			cc.ldr(arg.as<asmjit::a64::Vec>(), paramMem);
 		} else {
 			// ex: void example(__m128i xmmreg) is invalid: https://github.com/asmjit/asmjit/issues/83
-			_errorCode = "Parameters wider than 64bits not supported";
-			return nullptr;
+			error = "Parameters wider than 64bits not supported";
+			return {};
 		}
 
 		argRegisters.push_back(std::move(arg));
@@ -100,6 +238,7 @@ MemAddr JitCall::GetJitFunc(const asmjit::FuncSignature& sig, MemAddr target, Wa
 		// next structure slot (+= sizeof(uint64_t))
 		cc.add(i, i, sizeof(uint64_t));
 	}
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
 
 	// allows debuggers to trap
 	if (waitType == WaitType::Breakpoint) {
@@ -116,7 +255,7 @@ MemAddr JitCall::GetJitFunc(const asmjit::FuncSignature& sig, MemAddr target, Wa
 	asmjit::InvokeNode* invokeNode;
 	cc.invoke(&invokeNode,
 			(uint64_t) target.GetPtr(),
-			sig
+			callee
 	);
 
 	if (hidden) {
@@ -124,7 +263,7 @@ MemAddr JitCall::GetJitFunc(const asmjit::FuncSignature& sig, MemAddr target, Wa
 	}
 
 	// Map call params to the args
-	for (uint32_t argIdx = 0; argIdx < sig.argCount(); ++argIdx) {
+	for (uint32_t argIdx = 0; argIdx < callee.argCount(); ++argIdx) {
 		invokeNode->setArg(argIdx, argRegisters.at(argIdx));
 	}
 
@@ -160,27 +299,21 @@ MemAddr JitCall::GetJitFunc(const asmjit::FuncSignature& sig, MemAddr target, Wa
 	// end of the function body
 	cc.endFunc();
 
-	// write to buffer
-	cc.finalize();
-
-	asmjit::Error err = rt->add(&_function, &code);
-	if (err) {
-		_function = nullptr;
-		_errorCode = asmjit::DebugUtils::errorAsString(err);
-		return nullptr;
-	}
-
-	//PL_LOG_VERBOSE("JIT Stub:\n{}", log.data());
-
-	return _function;
+	return func->label();
 }
 
 MemAddr JitCall::GetJitFunc(MethodRef method, MemAddr target, WaitType waitType, HiddenParam hidden) {
+	bool retHidden;
+	asmjit::FuncSignature sig = GetSignature(method, hidden, retHidden);
+	return GetJitFunc(sig, target, waitType, retHidden);
+}
+
+asmjit::FuncSignature JitCall::GetSignature(MethodRef method, HiddenParam hidden, bool& retHidden) {
 	ValueType retType = method.GetReturnType().GetType();
-	bool retHidden = hidden(retType);
+	retHidden = hidden(retType);
 	asmjit::FuncSignature sig(JitUtils::GetCallConv(method.GetCallingConvention()), method.GetVarIndex(), JitUtils::GetRetTypeId(retHidden ? ValueType::Void : retType));
 	for (const auto& type : method.GetParamTypes()) {
 		sig.addArg(JitUtils::GetValueTypeId(type.IsReference() ? ValueType::Pointer : type.GetType()));
 	}
-	return GetJitFunc(sig, target, waitType, retHidden);
+	return sig;
 }
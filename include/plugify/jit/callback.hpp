@@ -168,6 +168,28 @@ namespace plugify {
 		 */
 		MemAddr GetJitFunc(MethodRef method, CallbackHandler callback, MemAddr data = nullptr, HiddenParam hidden = &ValueUtils::IsHiddenParam);
 
+		/**
+		 * @brief Build the raw signature of the method.
+		 * @param method Reference to the method.
+		 * @param hidden Tells whether a return type is passed as hidden argument.
+		 * @param retHidden Receives whether the return is passed as hidden argument.
+		 * @return The signature.
+		 */
+		static asmjit::FuncSignature GetSignature(MethodRef method, HiddenParam hidden, bool& retHidden);
+
+		/**
+		 * @brief Emit the stub as a function of the compiler.
+		 * @param compiler Compiler of the target architecture.
+		 * @param sig Function signature.
+		 * @param method Reference to the method.
+		 * @param callback Callback function.
+		 * @param data User data.
+		 * @param hidden If true, return will be pass as hidden argument.
+		 * @param error Receives the error message on failure.
+		 * @return Label of the stub, invalid on failure.
+		 */
+		static asmjit::Label EmitStub(asmjit::BaseCompiler& compiler, const asmjit::FuncSignature& sig, MethodRef method, CallbackHandler callback, MemAddr data, bool hidden, const char*& error);
+
 		/**
 		 * @brief Get a dynamically created function.
 		 * @return Pointer to the already generated function.
@@ -32,6 +32,29 @@ MemAddr JitCallback::GetJitFunc(const asmjit::FuncSignature& sig, MethodRef meth
 
 	_userData = data;
 
+	asmjit::CodeHolder code;
+	code.init(rt->environment(), rt->cpuFeatures());
+
+	asmjit::x86::Compiler cc(&code);
+	if (!EmitStub(cc, sig, method, callback, data, hidden, _errorCode).isValid())
+		return nullptr;
+
+	// write to buffer
+	cc.finalize();
+
+	asmjit::Error err = rt->add(&_function, &code);
+	if (err) {
+		_function = nullptr;
+		_errorCode = asmjit::DebugUtils::errorAsString(err);
+		return nullptr;
+	}
+
+	//PL_LOG_VERBOSE("JIT Stub:\n{}", log.data());
+
+	return _function;
+}
+
+asmjit::Label JitCallback::EmitStub(asmjit::BaseCompiler& compiler, const asmjit::FuncSignature& sig, MethodRef method, CallbackHandler callback, MemAddr data, bool hidden, const char*& error) {
 	/*
 	  AsmJit is smart enough to track register allocations and will forward
 	  the proper registers the right values and fixup any it dirtied earlier.
@@ -50,24 +73,103 @@ MemAddr JitCallback::GetJitFunc(const asmjit::FuncSignature& sig, MethodRef meth
 	  physical registers may be inserted as nodes.
 	*/
 
-	asmjit::CodeHolder code;
-	code.init(rt->environment(), rt->cpuFeatures());
+	auto& cc = static_cast<asmjit::x86::Compiler&>(compiler);
+
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	// vectors passed by value arrive in one register per part, the handler gets a pointer to them in their slot
+	asmjit::FuncSignature source;
+	std::vector<JitUtils::ArgPart> parts;
+	if (!JitUtils::ExpandSignature(sig, cc.environment(), source, parts, error))
+		return {};
 
 	// initialize function
-	asmjit::x86::Compiler cc(&code);
+	asmjit::FuncNode* func = cc.addFunc(source);
+#else
+	// initialize function
 	asmjit::FuncNode* func = cc.addFunc(sig);
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
 
 	/*StringLogger log;
 	auto kFormatFlags = FormatFlags::kMachineCode | FormatFlags::kExplainImms | FormatFlags::kRegCasts | FormatFlags::kHexImms | FormatFlags::kHexOffsets | FormatFlags::kPositions;
 
 	log.addFlags(kFormatFlags);
-	code.setLogger(&log);*/
+	cc.code()->setLogger(&log);*/
 
 #if PLUGIFY_IS_RELEASE
 	// too small to really need it
 	func->frame().resetPreservedFP();
 #endif
 
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	// map argument slots to registers, following abi.
+	std::vector<asmjit::x86::Reg> argRegisters;
+	argRegisters.reserve(parts.size());
+
+	for (uint32_t partIdx = 0; partIdx < parts.size(); partIdx++) {
+		const auto& argType = parts[partIdx].type;
+
+		asmjit::x86::Reg arg;
+		if (asmjit::TypeUtils::isInt(argType)) {
+			arg = cc.newUIntPtr();
+		} else if (asmjit::TypeUtils::isFloat(argType)) {
+			arg = cc.newXmm();
+		} else {
+			error = "Parameters wider than 64bits not supported";
+			return {};
+		}
+
+		func->setArg(partIdx, arg);
+		argRegisters.push_back(std::move(arg));
+	}
+
+	const uint32_t alignment = 16;
+
+	// setup the stack structure to hold arguments for user callback
+	const auto stackSize = static_cast<uint32_t>(sizeof(uint64_t) * sig.argCount());
+	asmjit::x86::Mem argsStack = cc.newStack(stackSize, alignment);
+
+	// each argument has a fixed slot, so address it at a constant displacement
+	auto argsStackIdx = [&](uint32_t argIdx) {
+		asmjit::x86::Mem slot(argsStack);
+		slot.addOffset(static_cast<int64_t>(argIdx * sizeof(uint64_t)));
+		slot.setSize(sizeof(uint64_t));
+		return slot;
+	};
+
+	asmjit::x86::Mem vectorStack;
+	uint32_t vectorIdx = asmjit::Globals::kInvalidId;
+
+	//// mov from arguments registers into the stack structure
+	for (uint32_t partIdx = 0; partIdx < parts.size(); ++partIdx) {
+		const auto& part = parts[partIdx];
+		asmjit::x86::Mem argMem = argsStackIdx(part.arg);
+
+		if (part.size) {
+			// spill the vector and pass a pointer to it in its slot
+			if (part.arg != vectorIdx) {
+				vectorStack = cc.newStack(sizeof(float) * 4, alignment);
+				vectorIdx = part.arg;
+
+				asmjit::x86::Gp vectorPtr = cc.newUIntPtr();
+				cc.lea(vectorPtr, vectorStack);
+				cc.mov(argMem, vectorPtr);
+			}
+			argMem = vectorStack;
+			argMem.addOffset(part.offset);
+			argMem.setSize(part.size);
+		}
+
+		// have to cast back to explicit register types to gen right mov type
+		if (asmjit::TypeUtils::isInt(part.type)) {
+			cc.mov(argMem, argRegisters.at(partIdx).as<asmjit::x86::Gp>());
+		} else if (part.size == sizeof(float)) {
+			// z of a Vector3
+			cc.movd(argMem, argRegisters.at(partIdx).as<asmjit::x86::Xmm>());
+		} else {
+			cc.movq(argMem, argRegisters.at(partIdx).as<asmjit::x86::Xmm>());
+		}
+	}
+#else
 	// map argument slots to registers, following abi.
 	std::vector<asmjit::x86::Reg> argRegisters;
 	argRegisters.reserve(sig.argCount());
@@ -81,8 +183,8 @@ MemAddr JitCallback::GetJitFunc(const asmjit::FuncSignature& sig, MethodRef meth
 		} else if (asmjit::TypeUtils::isFloat(argType)) {
 			arg = cc.newXmm();
 		} else {
-			_errorCode = "Parameters wider than 64bits not supported";
-			return nullptr;
+			error = "Parameters wider than 64bits not supported";
+			return {};
 		}
 
 		func->setArg(argIdx, arg);
@@ -118,13 +220,14 @@ MemAddr JitCallback::GetJitFunc(const asmjit::FuncSignature& sig, MethodRef meth
 		} else if (asmjit::TypeUtils::isFloat(argType)) {
 			cc.movq(argsStackIdx, argRegisters.at(argIdx).as<asmjit::x86::Xmm>());
 		} else {
-			_errorCode = "Parameters wider than 64bits not supported";
-			return nullptr;
+			error = "Parameters wider than 64bits not supported";
+			return {};
 		}
 
 		// next structure slot (+= sizeof(uint64_t))
 		cc.add(i, sizeof(uint64_t));
 	}
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
 
 	union {
 		MethodRef method;
@@ -182,6 +285,20 @@ MemAddr JitCallback::GetJitFunc(const asmjit::FuncSignature& sig, MethodRef meth
 	invokeNode->setArg(3, argCountParam);
 	invokeNode->setArg(4, retStruct);
 
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	// mov from arguments stack structure into regs
+	for (uint32_t partIdx = 0; partIdx < parts.size(); ++partIdx) {
+		const auto& part = parts[partIdx];
+		if (part.size)
+			continue;
+
+		if (asmjit::TypeUtils::isInt(part.type)) {
+			cc.mov(argRegisters.at(partIdx).as<asmjit::x86::Gp>(), argsStackIdx(part.arg));
+		} else {
+			cc.movq(argRegisters.at(partIdx).as<asmjit::x86::Xmm>(), argsStackIdx(part.arg));
+		}
+	}
+#else
 	// mov from arguments stack structure into regs
 	cc.mov(i, 0); // reset idx
 	for (uint32_t argIdx = 0; argIdx < sig.argCount(); ++argIdx) {
@@ -191,13 +308,14 @@ MemAddr JitCallback::GetJitFunc(const asmjit::FuncSignature& sig, MethodRef meth
 		} else if (asmjit::TypeUtils::isFloat(argType)) {
 			cc.movq(argRegisters.at(argIdx).as<asmjit::x86::Xmm>(), argsStackIdx);
 		} else {
-			_errorCode = "Parameters wider than 64bits not supported";
-			return nullptr;
+			error = "Parameters wider than 64bits not supported";
+			return {};
 		}
 
 		// next structure slot (+= sizeof(uint64_t))
 		cc.add(i, sizeof(uint64_t));
 	}
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
 
 	if (hidden) {
 		cc.ret(retStruct);
@@ -237,24 +355,18 @@ MemAddr JitCallback::GetJitFunc(const asmjit::FuncSignature& sig, MethodRef meth
 
 	cc.endFunc();
 
-	// write to buffer
-	cc.finalize();
-
-	asmjit::Error err = rt->add(&_function, &code);
-	if (err) {
-		_function = nullptr;
-		_errorCode = asmjit::DebugUtils::errorAsString(err);
-		return nullptr;
-	}
-
-	//PL_LOG_VERBOSE("JIT Stub:\n{}", log.data());
-
-	return _function;
+	return func->label();
 }
 
 MemAddr JitCallback::GetJitFunc(MethodRef method, CallbackHandler callback, MemAddr data, HiddenParam hidden) {
+	bool retHidden;
+	asmjit::FuncSignature sig = GetSignature(method, hidden, retHidden);
+	return GetJitFunc(sig, method, callback, data, retHidden);
+}
+
+asmjit::FuncSignature JitCallback::GetSignature(MethodRef method, HiddenParam hidden, bool& retHidden) {
 	ValueType retType = method.GetReturnType().GetType();
-	bool retHidden = hidden(retType);
+	retHidden = hidden(retType);
 	asmjit::FuncSignature sig(JitUtils::GetCallConv(method.GetCallingConvention()), method.GetVarIndex(), JitUtils::GetRetTypeId(retHidden ? ValueType::Pointer : retType));
 	if (retHidden) {
 		sig.addArg(JitUtils::GetValueTypeId(retType));
@@ -262,5 +374,5 @@ MemAddr JitCallback::GetJitFunc(MethodRef method, CallbackHandler callback, MemA
 	for (const auto& type : method.GetParamTypes()) {
 		sig.addArg(JitUtils::GetValueTypeId(type.IsReference() ? ValueType::Pointer : type.GetType()));
 	}
-	return GetJitFunc(sig, method, callback, data, retHidden);
+	return sig;
 }
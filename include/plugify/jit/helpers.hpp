@@ -2,6 +2,8 @@
 
 #include <asmjit/asmjit.h>
 #include <plugify/method.hpp>
+#include <memory>
+#include <vector>
 
 namespace plugify {
 	/**
@@ -18,5 +20,40 @@ namespace plugify {
 		[[nodiscard]] asmjit::TypeId GetRetTypeId(ValueType valueType) noexcept;
 
 		[[nodiscard]] asmjit::CallConvId GetCallConv([[maybe_unused]] std::string_view conv) noexcept;
+
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+		/**
+		 * @struct ArgPart
+		 * @brief Register sized argument of an expanded signature.
+		 */
+		struct ArgPart {
+			asmjit::TypeId type{};  ///< Type of the argument the ABI passes.
+			uint32_t arg{};         ///< Index of the argument in the signature it was expanded from.
+			uint32_t offset{};      ///< Offset of the part within a vector.
+			uint32_t size{};        ///< Bytes of the vector in the part, 0 if the argument is not a vector.
+		};
+
+		/**
+		 * @brief Expand vectors passed by value into the arguments the ABI passes them in.
+		 * @details GetValueTypeId encodes Vector2, Vector3 and Vector4 passed by value as kFloat32x2, kFloat64x2 and
+		 * kFloat32x4, which the ABI classifies as aggregates: two SSE eightbytes on System V x86-64, one general purpose
+		 * register for a Vector2 on Win64, one floating point register per element on AArch64. The slot of such an argument
+		 * in the parameters of a call or a callback holds a pointer to the vector, the stubs load or spill the parts.
+		 * @param sig Function signature.
+		 * @param environment Environment the stub is generated for.
+		 * @param expanded Receives the signature with every vector replaced by its parts.
+		 * @param parts Receives one part for every argument of the expanded signature.
+		 * @param error Receives the error message on failure.
+		 * @return True on success, false if a vector would be split between registers and the stack.
+		 */
+		[[nodiscard]] bool ExpandSignature(const asmjit::FuncSignature& sig, const asmjit::Environment& environment, asmjit::FuncSignature& expanded, std::vector<ArgPart>& parts, const char*& error);
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
+
+		/**
+		 * @brief Create a compiler of the target architecture.
+		 * @param code Code holder to attach the compiler to.
+		 * @return The compiler.
+		 */
+		[[nodiscard]] std::unique_ptr<asmjit::BaseCompiler> CreateCompiler(asmjit::CodeHolder& code);
 	} // namespace JitUtils
 } // namespace plugify
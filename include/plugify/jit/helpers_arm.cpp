@@ -1,3 +1,4 @@
+#include <asmjit/a64.h>
 #include "helpers.hpp"
 
 namespace plugify::JitUtils {
@@ -50,11 +51,23 @@ namespace plugify::JitUtils {
 			case ValueType::ArrayFloat:
 			case ValueType::ArrayDouble:
 			case ValueType::ArrayString:
+			// not a homogeneous aggregate, passed by reference
+			case ValueType::Matrix4x4:
+				return asmjit::TypeId::kUIntPtr;
+#if PLUGIFY_ARCH_BITS == 64 && PLUGIFY_JIT_VECTOR_BY_VALUE
+			// passed by value, see ExpandSignature
+			case ValueType::Vector2:
+				return asmjit::TypeId::kFloat32x2;
+			case ValueType::Vector3:
+				return asmjit::TypeId::kFloat64x2;
+			case ValueType::Vector4:
+				return asmjit::TypeId::kFloat32x4;
+#else
 			case ValueType::Vector2:
 			case ValueType::Vector3:
 			case ValueType::Vector4:
-			case ValueType::Matrix4x4:
 				return asmjit::TypeId::kUIntPtr;
+#endif // PLUGIFY_ARCH_BITS && PLUGIFY_JIT_VECTOR_BY_VALUE
 		}
 		return asmjit::TypeId::kVoid;
 	}
@@ -121,6 +134,72 @@ namespace plugify::JitUtils {
 		return asmjit::TypeId::kVoid;
 	}
 
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	bool ExpandSignature(const asmjit::FuncSignature& sig, const asmjit::Environment& environment, asmjit::FuncSignature& expanded, std::vector<ArgPart>& parts, const char*& error) {
+		parts.clear();
+		parts.reserve(sig.argCount());
+
+		uint32_t vaIndex = asmjit::FuncSignature::kNoVarArgs;
+		bool hasVector = false;
+		for (uint32_t argIdx = 0; argIdx < sig.argCount(); ++argIdx) {
+			if (argIdx == sig.vaIndex()) {
+				vaIndex = static_cast<uint32_t>(parts.size());
+			}
+
+			// Vector2, Vector3 and Vector4 are homogeneous float aggregates, one register per element
+			const auto& argType = sig.args()[argIdx];
+			uint32_t elements;
+			switch (argType) {
+				case asmjit::TypeId::kFloat32x2:
+					elements = 2;
+					break;
+				case asmjit::TypeId::kFloat64x2:
+					elements = 3;
+					break;
+				case asmjit::TypeId::kFloat32x4:
+					elements = 4;
+					break;
+				default:
+					elements = 0;
+					break;
+			}
+
+			if (elements == 0) {
+				parts.push_back({ argType, argIdx, 0, 0 });
+				continue;
+			}
+
+			for (uint32_t element = 0; element < elements; ++element) {
+				parts.push_back({ asmjit::TypeId::kFloat32, argIdx, static_cast<uint32_t>(sizeof(float) * element), sizeof(float) });
+			}
+			hasVector = true;
+		}
+
+		expanded = asmjit::FuncSignature(sig.callConvId(), vaIndex, sig.ret());
+		for (const auto& part : parts) {
+			expanded.addArg(part.type);
+		}
+
+		if (!hasVector)
+			return true;
+
+		// an aggregate which does not fit the remaining registers goes to the stack as a whole, with another layout than its elements
+		asmjit::FuncDetail detail;
+		if (detail.init(expanded, environment) != asmjit::kErrorOk) {
+			error = "Invalid signature";
+			return false;
+		}
+		for (uint32_t partIdx = 0; partIdx < parts.size(); ++partIdx) {
+			if (parts[partIdx].size && !detail.arg(partIdx).isReg()) {
+				error = "Vector argument does not fit the remaining registers";
+				return false;
+			}
+		}
+
+		return true;
+	}
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
+
 	asmjit::CallConvId GetCallConv([[maybe_unused]] std::string_view conv) noexcept {
 #if PLUGIFY_ARCH_BITS == 64
 		return asmjit::CallConvId::kHost;
@@ -136,4 +215,8 @@ namespace plugify::JitUtils {
 #endif // PLUGIFY_ARCH_BITS
 	}
 
+	std::unique_ptr<asmjit::BaseCompiler> CreateCompiler(asmjit::CodeHolder& code) {
+		return std::make_unique<asmjit::a64::Compiler>(&code);
+	}
+
 } // namespace plugify
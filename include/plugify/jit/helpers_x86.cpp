@@ -50,11 +50,29 @@ namespace plugify::JitUtils {
 			case ValueType::ArrayFloat:
 			case ValueType::ArrayDouble:
 			case ValueType::ArrayString:
+			case ValueType::Matrix4x4:
+				return asmjit::TypeId::kUIntPtr;
+#if PLUGIFY_ARCH_BITS == 64 && PLUGIFY_JIT_VECTOR_BY_VALUE
+			// passed by value, see ExpandSignature
 			case ValueType::Vector2:
+				return asmjit::TypeId::kFloat32x2;
+#if PLUGIFY_PLATFORM_WINDOWS
+			// Win64 passes structs of other sizes than 1, 2, 4 or 8 bytes by reference
 			case ValueType::Vector3:
 			case ValueType::Vector4:
-			case ValueType::Matrix4x4:
 				return asmjit::TypeId::kUIntPtr;
+#else
+			case ValueType::Vector3:
+				return asmjit::TypeId::kFloat64x2;
+			case ValueType::Vector4:
+				return asmjit::TypeId::kFloat32x4;
+#endif // PLUGIFY_PLATFORM_WINDOWS
+#else
+			case ValueType::Vector2:
+			case ValueType::Vector3:
+			case ValueType::Vector4:
+				return asmjit::TypeId::kUIntPtr;
+#endif // PLUGIFY_ARCH_BITS && PLUGIFY_JIT_VECTOR_BY_VALUE
 		}
 		return asmjit::TypeId::kVoid;
 	}
@@ -127,6 +145,68 @@ namespace plugify::JitUtils {
 		return asmjit::TypeId::kVoid;
 	}
 
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	bool ExpandSignature(const asmjit::FuncSignature& sig, const asmjit::Environment& environment, asmjit::FuncSignature& expanded, std::vector<ArgPart>& parts, const char*& error) {
+		parts.clear();
+		parts.reserve(sig.argCount());
+
+		uint32_t vaIndex = asmjit::FuncSignature::kNoVarArgs;
+		bool hasVector = false;
+		for (uint32_t argIdx = 0; argIdx < sig.argCount(); ++argIdx) {
+			if (argIdx == sig.vaIndex()) {
+				vaIndex = static_cast<uint32_t>(parts.size());
+			}
+
+			const auto& argType = sig.args()[argIdx];
+			switch (argType) {
+				case asmjit::TypeId::kFloat32x2: // Vector2, one eightbyte
+#if PLUGIFY_PLATFORM_WINDOWS
+					parts.push_back({ asmjit::TypeId::kInt64, argIdx, 0, sizeof(float) * 2 });
+#else
+					parts.push_back({ asmjit::TypeId::kFloat64, argIdx, 0, sizeof(float) * 2 });
+#endif // PLUGIFY_PLATFORM_WINDOWS
+					break;
+				case asmjit::TypeId::kFloat64x2: // Vector3, two SSE eightbytes, the second one holds z only
+					parts.push_back({ asmjit::TypeId::kFloat64, argIdx, 0, sizeof(float) * 2 });
+					parts.push_back({ asmjit::TypeId::kFloat64, argIdx, sizeof(float) * 2, sizeof(float) });
+					hasVector = true;
+					break;
+				case asmjit::TypeId::kFloat32x4: // Vector4, two SSE eightbytes
+					parts.push_back({ asmjit::TypeId::kFloat64, argIdx, 0, sizeof(float) * 2 });
+					parts.push_back({ asmjit::TypeId::kFloat64, argIdx, sizeof(float) * 2, sizeof(float) * 2 });
+					hasVector = true;
+					break;
+				default:
+					parts.push_back({ argType, argIdx, 0, 0 });
+					break;
+			}
+		}
+
+		expanded = asmjit::FuncSignature(sig.callConvId(), vaIndex, sig.ret());
+		for (const auto& part : parts) {
+			expanded.addArg(part.type);
+		}
+
+		if (!hasVector)
+			return true;
+
+		// System V passes a struct on the stack when not all of its eightbytes fit the remaining registers
+		asmjit::FuncDetail detail;
+		if (detail.init(expanded, environment) != asmjit::kErrorOk) {
+			error = "Invalid signature";
+			return false;
+		}
+		for (uint32_t partIdx = 1; partIdx < parts.size(); ++partIdx) {
+			if (parts[partIdx].size && parts[partIdx].offset && detail.arg(partIdx).isReg() != detail.arg(partIdx - 1).isReg()) {
+				error = "Vector argument split between registers and stack";
+				return false;
+			}
+		}
+
+		return true;
+	}
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
+
 	asmjit::CallConvId GetCallConv([[maybe_unused]] std::string_view conv) noexcept {
 #if PLUGIFY_ARCH_BITS == 64
 #if PLUGIFY_PLATFORM_WINDOWS
@@ -156,4 +236,8 @@ namespace plugify::JitUtils {
 #endif // PLUGIFY_ARCH_BITS
 	}
 
+	std::unique_ptr<asmjit::BaseCompiler> CreateCompiler(asmjit::CodeHolder& code) {
+		return std::make_unique<asmjit::x86::Compiler>(&code);
+	}
+
 } // namespace plugify
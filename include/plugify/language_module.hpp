@@ -4,6 +4,8 @@
 #include <cstring>
 #include <memory>
 #include <plugify/mem_addr.hpp>
+#include <plugify/plugin.hpp>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -127,5 +129,18 @@ namespace plugify {
 		* @return True if the assembly is build with debugging, false otherwise.
 		*/
 		virtual bool IsDebugBuild() = 0;
+
+		/**
+		 * @brief Handle method export event for several plugins at once.
+		 * @details Called once per export pass with every plugin which was loaded in it, in load order, instead of
+		 *          OnMethodExport. Only called for modules which set `batchMethodExport` in their .pmodule, since
+		 *          modules built against older headers have no such method. By default calls OnMethodExport for each plugin.
+		 * @param plugins References to the plugins exporting methods.
+		 */
+		virtual void OnMethodExportBatch(std::span<const PluginRef> plugins) {
+			for (const auto& plugin : plugins) {
+				OnMethodExport(plugin);
+			}
+		}
 	};
 } // namespace plugify
@@ -124,6 +124,20 @@ namespace plugify {
 		 * @return `true` if the module is forced to load, otherwise `false`.
 		 */
 		[[nodiscard]] bool IsForceLoad() const noexcept;
+
+		/**
+		 * @brief Checks if the language module can load and start plugins from multiple threads.
+		 *
+		 * @return `true` if `OnPluginLoad` and `OnPluginStart` are thread-safe, otherwise `false`.
+		 */
+		[[nodiscard]] bool IsThreadSafe() const noexcept;
+
+		/**
+		 * @brief Checks if the language module receives the methods to export in one batch.
+		 *
+		 * @return `true` if `OnMethodExportBatch` is called instead of `OnMethodExport`, otherwise `false`.
+		 */
+		[[nodiscard]] bool IsBatchMethodExport() const noexcept;
 	};
 	static_assert(is_ref_v<LanguageModuleDescriptorRef>);
 } // namespace plugify
@@ -99,6 +99,16 @@ namespace plugify {
 		 */
 		[[nodiscard]] uint8_t GetVarIndex() const noexcept;
 
+		/**
+		 * @brief Retrieves the hash of the method signature.
+		 *
+		 * The hash covers the calling convention, return and parameter types, including prototypes of function parameters,
+		 * but not the method or parameter names. Two methods with the same hash can be called through the same wrapper.
+		 *
+		 * @return A 64-bit hash of the method signature.
+		 */
+		[[nodiscard]] uint64_t GetSignatureHash() const noexcept;
+
 		/**
 		 * @brief Attempts to find a prototype method by its name in the current method's parameters or return type.
 		 *
@@ -101,6 +101,9 @@ namespace plugify {
 		 * If a user-overridden file exists in the base directory of Plugify with the same name and path,
 		 * the path returned by this function will direct to that overridden file.
 		 *
+		 * The resource directories of the module are indexed by the first call, later calls do not touch the file system.
+		 * Both '/' and the native separator are accepted, redundant separators and '.' segments are ignored.
+		 *
 		 * @param path The relative path to the resource file.
 		 * @return An optional containing the absolute path to the resource file if found, or std::nullopt otherwise.
 		 *
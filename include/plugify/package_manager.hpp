@@ -4,6 +4,7 @@
 #include <functional>
 #include <optional>
 #include <plugify_export.h>
+#include <span>
 
 namespace plugify {
 	struct LocalPackage;
@@ -52,6 +53,13 @@ namespace plugify {
 		 */
 		virtual bool Reload() = 0;
 
+		/**
+		 * @brief Re-read the descriptor of a single local package from disk.
+		 * @param packageName Name of the package to reload.
+		 * @return Optional reference to the reloaded local package, or empty if it is missing or its descriptor is invalid.
+		 */
+		virtual LocalPackageOpt ReloadLocalPackage(std::string_view packageName) = 0;
+
 		/**
 		 * @brief Install a package.
 		 * @param packageName Name of the package to install.
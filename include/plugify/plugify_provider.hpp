@@ -2,9 +2,12 @@
 
 #include <memory>
 #include <plugify/assembly.hpp>
+#include <plugify/method.hpp>
 #include <plugify/path.hpp>
+#include <plugify/plugin.hpp>
 #include <plugify/reference_wrapper.hpp>
 #include <plugify_export.h>
+#include <span>
 #include <string_view>
 #include <unordered_map>
 
@@ -74,6 +77,41 @@ namespace plugify {
 		 * @return True if the language module is loaded and meets the version requirements, false otherwise.
 		 */
 		[[nodiscard]] bool IsModuleLoaded(std::string_view name, std::optional<int32_t> requiredVersion = {}, bool minimum = false) const noexcept;
+
+		/**
+		 * @brief Resolves the address of a method exported by a plugin.
+		 * 
+		 * If the plugin is lazy and was not requested yet, it is loaded and started
+		 * together with its dependencies before the method is looked up.
+		 * 
+		 * @param pluginName The name of the plugin which exports the method.
+		 * @param methodName The name of the exported method.
+		 * @return The address of the method, or a null address if it could not be resolved.
+		 */
+		[[nodiscard]] MemAddr ResolveMethod(std::string_view pluginName, std::string_view methodName) const;
+
+		/**
+		 * @brief Finds a method exported by any loaded plugin with a single symbol table lookup.
+		 * 
+		 * Methods are registered under `plugin.method` as soon as their plugin is loaded.
+		 * If the owning plugin is lazy and was not requested yet, it is activated first.
+		 * 
+		 * @param name The qualified name of the method, in the `plugin.method` form.
+		 * @param signature Optional signature hash from `MethodRef::GetSignatureHash`, zero to skip the signature check.
+		 * @return The method and its address, or an empty optional if it is missing or its signature differs.
+		 */
+		[[nodiscard]] std::optional<MethodData> FindMethod(std::string_view name, uint64_t signature = 0) const;
+
+		/**
+		 * @brief Resolves the addresses of a whole import list at once.
+		 * 
+		 * Only the misses activate their lazy owning plugins, the same way as FindMethod does.
+		 * 
+		 * @param names The qualified names of the methods, in the `plugin.method` form.
+		 * @param addresses Output slots, one per name. Unresolved methods get a null address.
+		 * @return The number of resolved methods.
+		 */
+		size_t ResolveMethods(std::span<const std::string_view> names, std::span<MemAddr> addresses) const;
 	};
 	static_assert(is_ref_v<IPlugifyProvider>);
 } // namespace plugify
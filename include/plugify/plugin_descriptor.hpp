@@ -133,6 +133,13 @@ namespace plugify {
 		 * @return A span of `MethodRef` objects representing the exported methods.
 		 */
 		[[nodiscard]] std::span<const MethodRef> GetExportedMethods() const noexcept;
+
+		/**
+		 * @brief Checks if the plugin is loaded on first use instead of at startup.
+		 *
+		 * @return `true` if the plugin is lazy, otherwise `false`.
+		 */
+		[[nodiscard]] bool IsLazy() const noexcept;
 	};
 	static_assert(is_ref_v<PluginDescriptorRef>);
 } // namespace plugify
@@ -114,5 +114,25 @@ namespace plugify {
 		 * @return Vector of plugin references.
 		 */
 		[[nodiscard]] virtual std::vector<PluginRef> GetPlugins() const = 0;
+
+		/**
+		 * @brief Reload a plugin together with the plugins which depend on it.
+		 * @details Ends the plugin and its transitive dependents in reverse order, re-reads its descriptor
+		 *          and loads, exports and starts only that subgraph again. Other plugins keep running,
+		 *          and lazy plugins which were not activated yet stay unloaded unless the new descriptor requires them.
+		 *          Language modules have no per-plugin unload callback, so a module gets OnPluginLoad again
+		 *          right after OnPluginEnd and has to release the plugin's state in OnPluginEnd.
+		 * @param pluginName Name of the plugin to reload.
+		 * @return True if the plugin is running after the reload, false otherwise. Also false, with nothing stopped,
+		 * when the new descriptor depends on a plugin which is loaded after it.
+		 */
+		virtual bool ReloadPlugin(std::string_view pluginName) = 0;
+
+		/**
+		 * @brief Load and start a lazy plugin together with the plugins it depends on.
+		 * @param pluginName Name of the plugin to activate.
+		 * @return True if the plugin is running after the activation, false otherwise.
+		 */
+		virtual bool ActivatePlugin(std::string_view pluginName) = 0;
 	};
 } // namespace plugify
@@ -7,6 +7,8 @@ namespace plugify {
 		std::string language;
 		std::optional<std::vector<std::string>> libraryDirectories;
 		bool forceLoad{false};
+		bool threadSafe{false};
+		bool batchMethodExport{false};
 
 	private:
 		mutable std::shared_ptr<std::vector<std::string_view>> _supportedPlatforms;
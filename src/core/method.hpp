@@ -55,6 +55,30 @@ namespace plugify {
 	public:
 		static inline const uint8_t kNoVarArgs = 0xFFU;
 
+		// FNV-1a over the calling convention and every type, names are not part of the signature
+		[[nodiscard]] uint64_t GetSignatureHash() const noexcept {
+			uint64_t hash = 14695981039346656037ULL;
+			auto combine = [&hash](uint64_t value) {
+				hash = (hash ^ value) * 1099511628211ULL;
+			};
+			auto combineProperty = [&combine](const Property& property) {
+				combine(static_cast<uint64_t>(property.type));
+				combine(property.ref);
+				if (property.prototype) {
+					combine(property.prototype->GetSignatureHash());
+				}
+			};
+			for (char c : callConv) {
+				combine(static_cast<uint8_t>(c));
+			}
+			combineProperty(retType);
+			for (const auto& param : paramTypes) {
+				combineProperty(param);
+			}
+			combine(varIndex);
+			return hash;
+		}
+
 		[[nodiscard]] bool operator==(const Method& rhs) const noexcept { return name == rhs.name; }
 	};
 }
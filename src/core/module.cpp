@@ -4,6 +4,8 @@
 #include <plugify/module.hpp>
 #include <plugify/package.hpp>
 #include <plugify/plugify_provider.hpp>
+#include <utils/scope_guard.hpp>
+#include <utils/trace.hpp>
 
 #undef FindResource
 
@@ -21,9 +23,21 @@ Module::~Module() {
 	Terminate();
 }
 
-bool Module::Initialize(std::weak_ptr<IPlugifyProvider> provider) {
+bool Module::Initialize(std::weak_ptr<IPlugifyProvider> provider, bool measurePageFaults) {
 	PL_ASSERT(GetState() != ModuleState::Loaded, "Module already was initialized");
 
+	// Initialization runs on a single thread, so per-thread counters attribute the faults to this module only
+	_measurePageFaults = measurePageFaults;
+	PageFaults startFaults;
+	if (_measurePageFaults) {
+		startFaults = PageFaults::Capture();
+	}
+	ScopeGuard pageFaultsGuard([&] {
+		if (_measurePageFaults) {
+			_pageFaults = PageFaults::Capture() - startFaults;
+		}
+	});
+
 	std::error_code ec;
 
 	auto is_regular_file = [&](const fs::path& path) {
@@ -37,24 +51,11 @@ bool Module::Initialize(std::weak_ptr<IPlugifyProvider> provider) {
 
 	auto plugifyProvider = provider.lock();
 
-	fs::path_view baseDir = plugifyProvider->GetBaseDir();
-
+	// Resource directories are only walked when the module looks up its first resource
 	if (const auto& resourceDirectoriesSettings = GetDescriptor().resourceDirectories) {
-		for (const auto& rawPath : *resourceDirectoriesSettings) {
-			fs::path resourceDirectory = fs::absolute(_baseDir / rawPath, ec);
-			for (const auto& entry : fs::recursive_directory_iterator(resourceDirectory, ec)) {
-				if (entry.is_regular_file(ec)) {
-					fs::path relPath = fs::relative(entry.path(), _baseDir, ec);
-					fs::path absPath = baseDir / relPath;
-
-					if (!is_regular_file(absPath)) {
-						absPath = entry.path();
-					}
-
-					_resources.emplace(std::move(relPath), std::move(absPath));
-				}
-			}
-		}
+		_resources = std::make_unique<ResourceIndex>(_baseDir, fs::path(plugifyProvider->GetBaseDir()), *resourceDirectoriesSettings);
+	} else {
+		_resources.reset();
 	}
 
 	auto is_directory = [&](const fs::path& path) {
@@ -82,7 +83,11 @@ bool Module::Initialize(std::weak_ptr<IPlugifyProvider> provider) {
 		flags |= LoadFlag::Deepbind;
 	}
 
-	auto assembly = std::make_unique<Assembly>(fs::absolute(_filePath, ec), flags, libraryDirectories);
+	std::unique_ptr<Assembly> assembly;
+	{
+		PL_TRACE_SCOPE("Load assembly", "module", _name);
+		assembly = std::make_unique<Assembly>(fs::absolute(_filePath, ec), flags, libraryDirectories);
+	}
 	if (!assembly->IsValid()) {
 		SetError(std::format("Failed to load library: '{}' at: '{}' - {}", _name, _filePath.string(), assembly->GetError()));
 		return false;
@@ -112,7 +117,10 @@ bool Module::Initialize(std::weak_ptr<IPlugifyProvider> provider) {
 	}
 #endif // PLUGIFY_PLATFORM_WINDOWS
 
-	InitResult result = languageModulePtr->Initialize(std::move(provider), *this);
+	InitResult result = [&] {
+		PL_TRACE_SCOPE("Initialize", "module", _name);
+		return languageModulePtr->Initialize(std::move(provider), *this);
+	}();
 	if (auto* data = std::get_if<ErrorData>(&result)) {
 		SetError(std::format("Failed to initialize module: '{}' error: '{}' at: '{}'", _name, data->error.data(), _filePath.string()));
 		Terminate();
@@ -139,9 +147,18 @@ bool Module::LoadPlugin(Plugin& plugin) const {
 	if (_state != ModuleState::Loaded)
 		return false;
 
+	PL_TRACE_SCOPE("OnPluginLoad", "plugin", plugin.GetName());
+
 	const auto& exportedMethods = plugin.GetDescriptor().exportedMethods;
 
+	PageFaults startFaults;
+	if (_measurePageFaults) {
+		startFaults = PageFaults::Capture();
+	}
 	auto result = GetLanguageModule().OnPluginLoad(plugin);
+	if (_measurePageFaults) {
+		plugin.SetPageFaults(PageFaults::Capture() - startFaults);
+	}
 	if (auto* data =  std::get_if<ErrorData>(&result)) {
 		plugin.SetError(std::format("Failed to load plugin: '{}' error: '{}' at: '{}'", plugin.GetName(), data->error.data(), plugin.GetBaseDir().string()));
 		return false;
@@ -182,17 +199,28 @@ bool Module::LoadPlugin(Plugin& plugin) const {
 	return true;
 }
 
-void Module::MethodExport(Plugin& plugin) const {
+void Module::MethodExport(std::span<const PluginRef> plugins) const {
 	if (_state != ModuleState::Loaded)
 		return;
 
-	GetLanguageModule().OnMethodExport(plugin);
+	PL_TRACE_SCOPE("OnMethodExport", "module", _name);
+
+	// modules built before OnMethodExportBatch existed have no slot for it, only call it when asked to
+	if (_descriptor->batchMethodExport) {
+		GetLanguageModule().OnMethodExportBatch(plugins);
+	} else {
+		for (const auto& plugin : plugins) {
+			GetLanguageModule().OnMethodExport(plugin);
+		}
+	}
 }
 
 void Module::StartPlugin(Plugin& plugin) const  {
 	if (_state != ModuleState::Loaded)
 		return;
 
+	PL_TRACE_SCOPE("OnPluginStart", "plugin", plugin.GetName());
+
 	GetLanguageModule().OnPluginStart(plugin);
 
 	plugin.SetRunning();
@@ -202,20 +230,20 @@ void Module::EndPlugin(Plugin& plugin) const {
 	if (_state != ModuleState::Loaded)
 		return;
 
+	PL_TRACE_SCOPE("OnPluginEnd", "plugin", plugin.GetName());
+
 	GetLanguageModule().OnPluginEnd(plugin);
 
 	plugin.SetTerminating();
 }
 
-std::optional<fs::path_view> Module::FindResource(const fs::path& path) const {
-	auto it = _resources.find(path);
-	if (it != _resources.end())
-		return std::get<fs::path>(*it).c_str();
-	return {};
+std::optional<fs::path_view> Module::FindResource(fs::path_view path) const {
+	if (!_resources)
+		return {};
+	return _resources->Find(path);
 }
 
 void Module::SetError(std::string error) {
 	_error = std::make_unique<std::string>(std::move(error));
 	_state = ModuleState::Error;
-	PL_LOG_ERROR("Module '{}': {}", _name, *_error);
 }
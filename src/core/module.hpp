@@ -5,6 +5,8 @@
 #include <plugify/language_module.hpp>
 #include <plugify/module.hpp>
 #include <utils/hash.hpp>
+#include <utils/prefetch.hpp>
+#include <utils/resource_index.hpp>
 
 namespace plugify {
 	class Plugin;
@@ -51,15 +53,19 @@ namespace plugify {
 			return *_error;
 		}
 
-		std::optional<fs::path_view> FindResource(const fs::path& path) const;
+		const PageFaults& GetPageFaults() const noexcept {
+			return _pageFaults;
+		}
+
+		std::optional<fs::path_view> FindResource(fs::path_view path) const;
 
-		bool Initialize(std::weak_ptr<IPlugifyProvider> provider);
+		bool Initialize(std::weak_ptr<IPlugifyProvider> provider, bool measurePageFaults);
 		void Terminate();
 
 		bool LoadPlugin(Plugin& plugin) const;
 		void StartPlugin(Plugin& plugin) const;
 		void EndPlugin(Plugin& plugin) const;
-		void MethodExport(Plugin& plugin) const;
+		void MethodExport(std::span<const PluginRef> plugins) const;
 
 		void SetError(std::string error);
 
@@ -85,9 +91,11 @@ namespace plugify {
 		fs::path _filePath;
 		fs::path _baseDir;
 		std::shared_ptr<LanguageModuleDescriptor> _descriptor;
-		std::unordered_map<fs::path, fs::path, path_hash> _resources;
+		std::unique_ptr<ResourceIndex> _resources;
 		ModuleState _state{ ModuleState::NotLoaded };
 		std::unique_ptr<std::string> _error;
+		PageFaults _pageFaults;
+		bool _measurePageFaults{ false };
 		std::unique_ptr<Assembly> _assembly;
 		std::optional<std::reference_wrapper<ILanguageModule>> _languageModule;
 	};
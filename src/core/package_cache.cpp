@@ -0,0 +1,336 @@
+#include "package_cache.hpp"
+#include "language_module_descriptor.hpp"
+#include "plugin_descriptor.hpp"
+#include <utils/binary_stream.hpp>
+#include <utils/file_system.hpp>
+
+using namespace plugify;
+
+namespace {
+	constexpr uint32_t kMagic = 0x48434C50; // 'PLCH'
+
+	void WriteMethod(BinaryWriter& writer, const Method& method);
+
+	void WriteProperty(BinaryWriter& writer, const Property& property) {
+		writer.Write(property.type);
+		writer.Write(property.ref);
+		writer.Write(property.prototype != nullptr);
+		if (property.prototype) {
+			WriteMethod(writer, *property.prototype);
+		}
+	}
+
+	void WriteMethod(BinaryWriter& writer, const Method& method) {
+		writer.Write(method.name);
+		writer.Write(method.funcName);
+		writer.Write(method.callConv);
+		writer.Write(static_cast<uint32_t>(method.paramTypes.size()));
+		for (const auto& param : method.paramTypes) {
+			WriteProperty(writer, param);
+		}
+		WriteProperty(writer, method.retType);
+		writer.Write(method.varIndex);
+	}
+
+	void WriteDescriptor(BinaryWriter& writer, const Descriptor& descriptor) {
+		writer.Write(descriptor.fileVersion);
+		writer.Write(descriptor.version);
+		writer.Write(descriptor.versionName);
+		writer.Write(descriptor.friendlyName);
+		writer.Write(descriptor.description);
+		writer.Write(descriptor.createdBy);
+		writer.Write(descriptor.createdByURL);
+		writer.Write(descriptor.docsURL);
+		writer.Write(descriptor.downloadURL);
+		writer.Write(descriptor.updateURL);
+		writer.Write(descriptor.supportedPlatforms);
+		writer.Write(descriptor.resourceDirectories);
+	}
+
+	void WritePluginDescriptor(BinaryWriter& writer, const PluginDescriptor& descriptor) {
+		WriteDescriptor(writer, descriptor);
+		writer.Write(descriptor.entryPoint);
+		writer.Write(descriptor.languageModule.name);
+		writer.Write(static_cast<uint32_t>(descriptor.dependencies.size()));
+		for (const auto& dependency : descriptor.dependencies) {
+			writer.Write(dependency.name);
+			writer.Write(dependency.optional);
+			writer.Write(dependency.supportedPlatforms);
+			writer.Write(dependency.requestedVersion);
+		}
+		writer.Write(static_cast<uint32_t>(descriptor.exportedMethods.size()));
+		for (const auto& method : descriptor.exportedMethods) {
+			WriteMethod(writer, method);
+		}
+		writer.Write(descriptor.lazy);
+	}
+
+	void WriteModuleDescriptor(BinaryWriter& writer, const LanguageModuleDescriptor& descriptor) {
+		WriteDescriptor(writer, descriptor);
+		writer.Write(descriptor.language);
+		writer.Write(descriptor.libraryDirectories);
+		writer.Write(descriptor.forceLoad);
+		writer.Write(descriptor.threadSafe);
+		writer.Write(descriptor.batchMethodExport);
+	}
+
+	bool ReadMethod(BinaryReader& reader, Method& method);
+
+	bool ReadProperty(BinaryReader& reader, Property& property) {
+		bool hasPrototype{};
+		if (!reader.Read(property.type) || !reader.Read(property.ref) || !reader.Read(hasPrototype))
+			return false;
+		if (hasPrototype) {
+			property.prototype = std::make_shared<Method>();
+			return ReadMethod(reader, *property.prototype);
+		}
+		return true;
+	}
+
+	bool ReadMethod(BinaryReader& reader, Method& method) {
+		uint32_t paramCount{};
+		if (!reader.Read(method.name) || !reader.Read(method.funcName) || !reader.Read(method.callConv) || !reader.Read(paramCount))
+			return false;
+		for (uint32_t i = 0; i < paramCount; ++i) {
+			if (!ReadProperty(reader, method.paramTypes.emplace_back()))
+				return false;
+		}
+		return ReadProperty(reader, method.retType) && reader.Read(method.varIndex);
+	}
+
+	bool ReadDescriptor(BinaryReader& reader, Descriptor& descriptor) {
+		return reader.Read(descriptor.fileVersion) &&
+			   reader.Read(descriptor.version) &&
+			   reader.Read(descriptor.versionName) &&
+			   reader.Read(descriptor.friendlyName) &&
+			   reader.Read(descriptor.description) &&
+			   reader.Read(descriptor.createdBy) &&
+			   reader.Read(descriptor.createdByURL) &&
+			   reader.Read(descriptor.docsURL) &&
+			   reader.Read(descriptor.downloadURL) &&
+			   reader.Read(descriptor.updateURL) &&
+			   reader.Read(descriptor.supportedPlatforms) &&
+			   reader.Read(descriptor.resourceDirectories);
+	}
+
+	std::shared_ptr<PluginDescriptor> ReadPluginDescriptor(BinaryReader& reader) {
+		auto descriptor = std::make_shared<PluginDescriptor>();
+		uint32_t dependencyCount{};
+		if (!ReadDescriptor(reader, *descriptor) || !reader.Read(descriptor->entryPoint) || !reader.Read(descriptor->languageModule.name) || !reader.Read(dependencyCount))
+			return {};
+		for (uint32_t i = 0; i < dependencyCount; ++i) {
+			auto& dependency = descriptor->dependencies.emplace_back();
+			if (!reader.Read(dependency.name) || !reader.Read(dependency.optional) || !reader.Read(dependency.supportedPlatforms) || !reader.Read(dependency.requestedVersion))
+				return {};
+		}
+		uint32_t methodCount{};
+		if (!reader.Read(methodCount))
+			return {};
+		for (uint32_t i = 0; i < methodCount; ++i) {
+			if (!ReadMethod(reader, descriptor->exportedMethods.emplace_back()))
+				return {};
+		}
+		if (!reader.Read(descriptor->lazy))
+			return {};
+		return descriptor;
+	}
+
+	std::shared_ptr<LanguageModuleDescriptor> ReadModuleDescriptor(BinaryReader& reader) {
+		auto descriptor = std::make_shared<LanguageModuleDescriptor>();
+		if (!ReadDescriptor(reader, *descriptor) || !reader.Read(descriptor->language) || !reader.Read(descriptor->libraryDirectories) || !reader.Read(descriptor->forceLoad) || !reader.Read(descriptor->threadSafe) || !reader.Read(descriptor->batchMethodExport))
+			return {};
+		return descriptor;
+	}
+}
+
+bool PackageCache::Load(const fs::path& filePath) {
+	_entries.clear();
+	_loadOrder.clear();
+	_loadOrderHash = 0;
+	_dirty = false;
+
+	if (!FileSystem::IsExists(filePath))
+		return false;
+
+	bool loaded = false;
+
+	FileSystem::ReadBytes(filePath, [&](std::span<const uint8_t> buffer) {
+		BinaryReader header(buffer);
+		uint32_t magic{}, version{};
+		uint64_t hash{};
+		if (!header.Read(magic) || !header.Read(version) || !header.Read(hash) || magic != kMagic || version != kFormatVersion)
+			return;
+
+		constexpr size_t kHeaderSize = sizeof(magic) + sizeof(version) + sizeof(hash);
+		auto body = buffer.subspan(kHeaderSize);
+		if (GetHash({ reinterpret_cast<const char*>(body.data()), body.size() }) != hash)
+			return;
+
+		BinaryReader reader(body);
+		uint32_t entryCount{};
+		if (!reader.Read(entryCount))
+			return;
+
+		for (uint32_t i = 0; i < entryCount; ++i) {
+			std::string path;
+			Entry entry;
+			auto& package = entry.package;
+			if (!reader.Read(path) || !reader.Read(entry.stamp.size) || !reader.Read(entry.stamp.time) || !reader.Read(entry.hash) ||
+				!reader.Read(package.name) || !reader.Read(package.type) || !reader.Read(package.version))
+				return;
+			if (package.type == "plugin") {
+				package.descriptor = ReadPluginDescriptor(reader);
+			} else {
+				package.descriptor = ReadModuleDescriptor(reader);
+			}
+			if (!package.descriptor)
+				return;
+			package.path = path;
+			_entries.emplace(std::move(path), std::move(entry));
+		}
+
+		loaded = reader.Read(_loadOrderHash) && reader.Read(_loadOrder) && reader.IsEnd();
+	});
+
+	if (!loaded) {
+		PL_LOG_WARNING("Package cache: '{}' is invalid or outdated and will be rebuilt", filePath.string());
+		_entries.clear();
+		_loadOrder.clear();
+		_loadOrderHash = 0;
+		_dirty = true;
+	}
+
+	return loaded;
+}
+
+bool PackageCache::Save(const fs::path& filePath) {
+	if (!_dirty)
+		return true;
+
+	BinaryWriter writer;
+	writer.Write(static_cast<uint32_t>(_entries.size()));
+	for (const auto& [path, entry] : _entries) {
+		const auto& package = entry.package;
+		writer.Write(path);
+		writer.Write(entry.stamp.size);
+		writer.Write(entry.stamp.time);
+		writer.Write(entry.hash);
+		writer.Write(package.name);
+		writer.Write(package.type);
+		writer.Write(package.version);
+		if (package.type == "plugin") {
+			WritePluginDescriptor(writer, *std::static_pointer_cast<PluginDescriptor>(package.descriptor));
+		} else {
+			WriteModuleDescriptor(writer, *std::static_pointer_cast<LanguageModuleDescriptor>(package.descriptor));
+		}
+	}
+	writer.Write(_loadOrderHash);
+	writer.Write(_loadOrder);
+
+	auto body = writer.GetData();
+
+	BinaryWriter header;
+	header.Write(kMagic);
+	header.Write(kFormatVersion);
+	header.Write(GetHash({ reinterpret_cast<const char*>(body.data()), body.size() }));
+
+	std::vector<uint8_t> buffer;
+	buffer.reserve(header.GetData().size() + body.size());
+	buffer.insert(buffer.end(), header.GetData().begin(), header.GetData().end());
+	buffer.insert(buffer.end(), body.begin(), body.end());
+
+	if (!FileSystem::WriteBytes(filePath, buffer))
+		return false;
+
+	_dirty = false;
+	return true;
+}
+
+std::optional<LocalPackage> PackageCache::Find(const fs::path& path, const Stamp& stamp) {
+	auto it = _entries.find(path.string());
+	if (it == _entries.end())
+		return {};
+	auto& entry = std::get<Entry>(*it);
+	if (entry.stamp != stamp)
+		return {};
+	entry.used = true;
+	return entry.package;
+}
+
+std::optional<LocalPackage> PackageCache::Find(const fs::path& path, const Stamp& stamp, uint64_t hash) {
+	auto it = _entries.find(path.string());
+	if (it == _entries.end())
+		return {};
+	auto& entry = std::get<Entry>(*it);
+	if (entry.hash != hash)
+		return {};
+	// Touched but not changed, only the stamp is refreshed
+	entry.stamp = stamp;
+	entry.used = true;
+	_dirty = true;
+	return entry.package;
+}
+
+void PackageCache::Store(const fs::path& path, const Stamp& stamp, uint64_t hash, const LocalPackage& package) {
+	_entries.insert_or_assign(path.string(), Entry{ stamp, hash, package, true });
+	_dirty = true;
+}
+
+void PackageCache::RemoveUnused() {
+	auto removed = std::erase_if(_entries, [](const auto& pair) {
+		return !std::get<Entry>(pair).used;
+	});
+	if (removed) {
+		_dirty = true;
+	}
+}
+
+std::span<const std::string> PackageCache::GetLoadOrder() const {
+	if (_loadOrder.empty() || _loadOrderHash != GetPluginsHash())
+		return {};
+	return _loadOrder;
+}
+
+void PackageCache::SetLoadOrder(std::vector<std::string> loadOrder) {
+	_loadOrder = std::move(loadOrder);
+	_loadOrderHash = GetPluginsHash();
+	_dirty = true;
+}
+
+std::optional<PackageCache::Stamp> PackageCache::GetStamp(const fs::path& path) {
+	std::error_code ec;
+	auto size = fs::file_size(path, ec);
+	if (ec)
+		return {};
+	auto time = fs::last_write_time(path, ec);
+	if (ec)
+		return {};
+	return Stamp{ static_cast<uint64_t>(size), static_cast<int64_t>(time.time_since_epoch().count()) };
+}
+
+uint64_t PackageCache::GetHash(std::string_view text) noexcept {
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for (char c : text) {
+		hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+uint64_t PackageCache::GetPluginsHash() const {
+	// The load order only depends on plugin descriptors, so any changed, added or removed plugin invalidates it
+	std::vector<std::pair<std::string_view, uint64_t>> plugins;
+	for (const auto& [path, entry] : _entries) {
+		if (entry.used && entry.package.type == "plugin") {
+			plugins.emplace_back(path, entry.hash);
+		}
+	}
+	std::sort(plugins.begin(), plugins.end());
+
+	uint64_t hash = 14695981039346656037ULL;
+	for (const auto& [path, contentHash] : plugins) {
+		hash = (hash ^ GetHash(path)) * 1099511628211ULL;
+		hash = (hash ^ contentHash) * 1099511628211ULL;
+	}
+	return hash;
+}
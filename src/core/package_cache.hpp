@@ -0,0 +1,53 @@
+#pragma once
+
+#include <plugify/package.hpp>
+#include <utils/hash.hpp>
+
+namespace plugify {
+	class PackageCache {
+	public:
+		struct Stamp {
+			uint64_t size{};
+			int64_t time{};
+
+			bool operator==(const Stamp&) const = default;
+		};
+
+		bool Load(const fs::path& filePath);
+		bool Save(const fs::path& filePath);
+
+		std::optional<LocalPackage> Find(const fs::path& path, const Stamp& stamp);
+		std::optional<LocalPackage> Find(const fs::path& path, const Stamp& stamp, uint64_t hash);
+		void Store(const fs::path& path, const Stamp& stamp, uint64_t hash, const LocalPackage& package);
+		void RemoveUnused();
+
+		std::span<const std::string> GetLoadOrder() const;
+		void SetLoadOrder(std::vector<std::string> loadOrder);
+
+		bool IsDirty() const noexcept {
+			return _dirty;
+		}
+
+		static std::optional<Stamp> GetStamp(const fs::path& path);
+		static uint64_t GetHash(std::string_view text) noexcept;
+
+		static inline const char* const kFileName = "plugify.pcache";
+		static inline const uint32_t kFormatVersion = 2;
+
+	private:
+		struct Entry {
+			Stamp stamp;
+			uint64_t hash{};
+			LocalPackage package;
+			bool used{};
+		};
+
+		uint64_t GetPluginsHash() const;
+
+	private:
+		std::unordered_map<std::string, Entry, string_hash, std::equal_to<>> _entries;
+		std::vector<std::string> _loadOrder;
+		uint64_t _loadOrderHash{};
+		bool _dirty{};
+	};
+}
@@ -1,5 +1,6 @@
 #include "package_manager.hpp"
 #include "module.hpp"
+#include "package_cache.hpp"
 #include "package_manifest.hpp"
 #include "plugin.hpp"
 
@@ -8,6 +9,7 @@
 #include <utils/file_system.hpp>
 #include <utils/json.hpp>
 #include <utils/strings.hpp>
+#include <utils/trace.hpp>
 #if PLUGIFY_DOWNLOADER
 #include <utils/http_downloader.hpp>
 #include <utils/sha256.hpp>
@@ -203,8 +205,9 @@ void ValidateDirectories(std::vector<std::string>& errors, const std::vector<std
 }
 
 template<typename T>
-std::optional<LocalPackage> GetPackageFromDescriptor(const fs::path& path, const std::string& name) {
-	auto json = FileSystem::ReadText(path);
+std::optional<LocalPackage> GetPackageFromDescriptor(std::string_view json, const fs::path& path, const std::string& name) {
+	PL_TRACE_SCOPE("Parse descriptor", "descriptor", name);
+
 	auto descriptor = glz::read_json<T>(json);
 	if (!descriptor.has_value()) {
 		PL_LOG_ERROR("Package: '{}' has JSON parsing error: {}", name, glz::format_error(descriptor.error(), json));
@@ -276,9 +279,20 @@ void PackageManager::LoadLocalPackages()  {
 
 	PL_LOG_DEBUG("Loading local packages");
 
+	PL_TRACE_SCOPE("Discover packages", "discovery", "");
+
 	_localPackages.clear();
 	//_localPackages.reserve()
 
+	if (plugify->GetConfig().packageCache) {
+		if (!_packageCache) {
+			_packageCache = std::make_unique<PackageCache>();
+		}
+		_packageCache->Load(plugify->GetConfig().baseDir / PackageCache::kFileName);
+	} else {
+		_packageCache.reset();
+	}
+
 	FileSystem::ReadDirectory(plugify->GetConfig().baseDir, [&](const fs::path& path, int depth) {
 		if (depth != 1)
 			return;
@@ -292,9 +306,7 @@ void PackageManager::LoadLocalPackages()  {
 		if (name.empty())
 			return;
 
-		auto package = isModule ?
-				GetPackageFromDescriptor<LanguageModuleDescriptor>(path, name) :
-				GetPackageFromDescriptor<PluginDescriptor>(path, name);
+		auto package = ReadLocalPackage(path, name, isModule);
 		if (!package.has_value())
 			return;
 
@@ -316,6 +328,79 @@ void PackageManager::LoadLocalPackages()  {
 			}
 		}
 	}, 3);
+
+	if (_packageCache) {
+		_packageCache->RemoveUnused();
+		SavePackageCache();
+	}
+}
+
+std::optional<LocalPackage> PackageManager::ReadLocalPackage(const fs::path& path, const std::string& name, bool isModule) {
+	// Unchanged size and time means an unchanged file, so it is not even read
+	auto stamp = _packageCache ? PackageCache::GetStamp(path) : std::nullopt;
+	if (stamp) {
+		if (auto package = _packageCache->Find(path, *stamp))
+			return package;
+	}
+
+	auto json = FileSystem::ReadText(path);
+
+	uint64_t hash = 0;
+	if (stamp) {
+		hash = PackageCache::GetHash(json);
+		if (auto package = _packageCache->Find(path, *stamp, hash))
+			return package;
+	}
+
+	auto package = isModule ?
+			GetPackageFromDescriptor<LanguageModuleDescriptor>(json, path, name) :
+			GetPackageFromDescriptor<PluginDescriptor>(json, path, name);
+	if (package.has_value() && stamp) {
+		_packageCache->Store(path, *stamp, hash, *package);
+	}
+	return package;
+}
+
+void PackageManager::SavePackageCache() {
+	if (!_packageCache || !_packageCache->IsDirty())
+		return;
+
+	auto plugify = _plugify.lock();
+	PL_ASSERT(plugify);
+
+	auto filePath = plugify->GetConfig().baseDir / PackageCache::kFileName;
+	if (!_packageCache->Save(filePath)) {
+		PL_LOG_WARNING("Package cache: '{}' could not be written", filePath.string());
+	}
+}
+
+std::span<const std::string> PackageManager::GetCachedLoadOrder() const {
+	if (!_packageCache)
+		return {};
+	return _packageCache->GetLoadOrder();
+}
+
+void PackageManager::SetCachedLoadOrder(std::vector<std::string> loadOrder) {
+	if (!_packageCache)
+		return;
+	_packageCache->SetLoadOrder(std::move(loadOrder));
+	SavePackageCache();
+}
+
+LocalPackageOpt PackageManager::ReloadLocalPackage(std::string_view packageName) {
+	auto it = _localPackages.find(packageName);
+	if (it == _localPackages.end())
+		return {};
+
+	auto& existingPackage = std::get<LocalPackage>(*it);
+
+	auto package = ReadLocalPackage(existingPackage.path, existingPackage.name, existingPackage.type != "plugin");
+	if (!package.has_value())
+		return {};
+
+	existingPackage = std::move(*package);
+	SavePackageCache();
+	return existingPackage;
 }
 
 #if PLUGIFY_DOWNLOADER
@@ -10,6 +10,7 @@ namespace plugify {
 #if PLUGIFY_DOWNLOADER
 	class HTTPDownloader;
 #endif // PLUGIFY_DOWNLOADER
+	class PackageCache;
 	class PackageManager final : public IPackageManager, public PlugifyContext {
 	public:
 		explicit PackageManager(std::weak_ptr<IPlugify> plugify);
@@ -21,6 +22,7 @@ namespace plugify {
 		void Terminate() override;
 		bool IsInitialized() const override;
 		bool Reload() override;
+		LocalPackageOpt ReloadLocalPackage(std::string_view packageName) override;
 
 		void InstallPackage(std::string_view packageName, std::optional<int32_t> requiredVersion) override;
 		void InstallPackages(std::span<const std::string> packageNames) override;
@@ -48,6 +50,9 @@ namespace plugify {
 		std::vector<LocalPackage> GetLocalPackages() const override;
 		std::vector<RemotePackage> GetRemotePackages() const override;
 
+		std::span<const std::string> GetCachedLoadOrder() const;
+		void SetCachedLoadOrder(std::vector<std::string> loadOrder);
+
 	public:
 		static bool IsSupportsPlatform(std::span<const std::string> supportedPlatforms) {
 			return supportedPlatforms.empty() || std::find(supportedPlatforms.begin(), supportedPlatforms.end(), PLUGIFY_PLATFORM) != supportedPlatforms.end();
@@ -56,6 +61,8 @@ namespace plugify {
 	private:
 		void LoadAllPackages();
 		void LoadLocalPackages();
+		std::optional<LocalPackage> ReadLocalPackage(const fs::path& path, const std::string& name, bool isModule);
+		void SavePackageCache();
 #if PLUGIFY_DOWNLOADER
 		void LoadRemotePackages();
 		void FindDependencies();
@@ -77,6 +84,7 @@ namespace plugify {
 #if PLUGIFY_DOWNLOADER
 		std::unique_ptr<HTTPDownloader> _httpDownloader;
 #endif // PLUGIFY_DOWNLOADER
+		std::unique_ptr<PackageCache> _packageCache;
 		std::unordered_map<std::string, LocalPackage, string_hash, std::equal_to<>> _localPackages;
 		std::unordered_map<std::string, RemotePackage, string_hash, std::equal_to<>> _remotePackages;
 		std::unordered_map<std::string, Dependency> _missedPackages;
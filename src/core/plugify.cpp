@@ -7,6 +7,7 @@
 #include <utils/http_downloader.hpp>
 #include <utils/json.hpp>
 #include <utils/strings.hpp>
+#include <utils/trace.hpp>
 
 namespace plugify {
 	class Plugify final : public IPlugify, public std::enable_shared_from_this<Plugify> {
@@ -33,6 +34,12 @@ namespace plugify {
 			if (!rootDir.empty())
 				_config.baseDir = rootDir / _config.baseDir;
 
+			if (!_config.traceFile.empty()) {
+				if (!rootDir.empty())
+					_config.traceFile = rootDir / _config.traceFile;
+				TraceSystem::SetEnabled(true);
+			}
+
 			_provider = std::make_shared<PlugifyProvider>(weak_from_this());
 			_packageManager = std::make_shared<PackageManager>(weak_from_this());
 			_pluginManager = std::make_shared<PluginManager>(weak_from_this());
@@ -61,6 +68,11 @@ namespace plugify {
 			}
 			_pluginManager.reset();
 
+			if (TraceSystem::IsEnabled()) {
+				TraceSystem::Write(_config.traceFile);
+				TraceSystem::SetEnabled(false);
+			}
+
 			_inited = false;
 
 			PL_LOG_INFO("Plugify Terminated!");
@@ -1,5 +1,6 @@
 #include "plugify_provider.hpp"
 #include "plugin_descriptor.hpp"
+#include "plugin_manager.hpp"
 #include <plugify/language_module_descriptor.hpp>
 #include <plugify/module.hpp>
 #include <plugify/plugin.hpp>
@@ -77,3 +78,33 @@ bool PlugifyProvider::IsModuleLoaded(std::string_view name, std::optional<int32_
 	}
 	return false;
 }
+
+MemAddr PlugifyProvider::ResolveMethod(std::string_view pluginName, std::string_view methodName) {
+	auto method = FindMethod(SymbolTable::MakeName(pluginName, methodName), 0);
+	if (method.has_value())
+		return method->second;
+	return {};
+}
+
+std::optional<MethodData> PlugifyProvider::FindMethod(std::string_view name, uint64_t signature) {
+	if (auto pluginManager = GetPluginManager()) {
+		return pluginManager->FindMethod(name, signature);
+	}
+	return {};
+}
+
+size_t PlugifyProvider::ResolveMethods(std::span<const std::string_view> names, std::span<MemAddr> addresses) {
+	if (auto pluginManager = GetPluginManager()) {
+		return pluginManager->ResolveMethods(names, addresses);
+	}
+	std::fill(addresses.begin(), addresses.end(), MemAddr{});
+	return 0;
+}
+
+std::shared_ptr<PluginManager> PlugifyProvider::GetPluginManager() const {
+	if (auto plugify = _plugify.lock()) {
+		// The core always creates its own plugin manager, so the symbol table can be reached directly
+		return std::static_pointer_cast<PluginManager>(plugify->GetPluginManager().lock());
+	}
+	return {};
+}
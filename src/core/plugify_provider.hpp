@@ -5,6 +5,7 @@
 #include <plugify/plugify_provider.hpp>
 
 namespace plugify {
+	class PluginManager;
 	class PlugifyProvider final : public IPlugifyProvider, public PlugifyContext {
 	public:
 		explicit PlugifyProvider(std::weak_ptr<IPlugify> plugify);
@@ -19,5 +20,14 @@ namespace plugify {
 		bool IsPluginLoaded(std::string_view name, std::optional<int32_t> requiredVersion = {}, bool minimum = false) noexcept;
 		
 		bool IsModuleLoaded(std::string_view name, std::optional<int32_t> requiredVersion = {}, bool minimum = false) noexcept;
+
+		MemAddr ResolveMethod(std::string_view pluginName, std::string_view methodName);
+
+		std::optional<MethodData> FindMethod(std::string_view name, uint64_t signature);
+
+		size_t ResolveMethods(std::span<const std::string_view> names, std::span<MemAddr> addresses);
+
+	private:
+		std::shared_ptr<PluginManager> GetPluginManager() const;
 	};
 }
@@ -19,46 +19,27 @@ Plugin::~Plugin() {
 bool Plugin::Initialize(std::weak_ptr<IPlugifyProvider> provider) {
 	PL_ASSERT(GetState() != PluginState::Loaded, "Plugin already was initialized");
 
-	std::error_code ec;
-
-	auto is_regular_file = [&](const fs::path& path) {
-		return fs::exists(path, ec) && fs::is_regular_file(path, ec);
-	};
-
 	auto plugifyProvider = provider.lock();
 
-	fs::path_view baseDir = plugifyProvider->GetBaseDir();
-
+	// Resource directories are only walked when the plugin looks up its first resource
 	if (const auto& resourceDirectoriesSettings = GetDescriptor().resourceDirectories) {
-		for (const auto& rawPath : *resourceDirectoriesSettings) {
-			fs::path resourceDirectory = fs::absolute(_baseDir / rawPath, ec);
-			for (const auto& entry : fs::recursive_directory_iterator(resourceDirectory, ec)) {
-				if (entry.is_regular_file(ec)) {
-					fs::path relPath = fs::relative(entry.path(), _baseDir, ec);
-					fs::path absPath = baseDir / relPath;
-
-					if (!is_regular_file(absPath)) {
-						absPath = entry.path();
-					}
-
-					_resources.emplace(std::move(relPath), std::move(absPath));
-				}
-			}
-		}
+		_resources = std::make_unique<ResourceIndex>(_baseDir, fs::path(plugifyProvider->GetBaseDir()), *resourceDirectoriesSettings);
+	} else {
+		_resources.reset();
 	}
 
 	return true;
 }
 
 void Plugin::Terminate() {
+	_methods.clear();
 	SetUnloaded();
 }
 
-std::optional<fs::path_view> Plugin::FindResource(const fs::path& path) const {
-	auto it = _resources.find(path);
-	if (it != _resources.end())
-		return std::get<fs::path>(*it).c_str();
-	return {};
+std::optional<fs::path_view> Plugin::FindResource(fs::path_view path) const {
+	if (!_resources)
+		return {};
+	return _resources->Find(path);
 }
 
 void Plugin::SetError(std::string error) {
@@ -4,6 +4,8 @@
 #include <plugify/plugin.hpp>
 #include <utils/hash.hpp>
 #include <utils/pointer.hpp>
+#include <utils/prefetch.hpp>
+#include <utils/resource_index.hpp>
 
 namespace plugify {
 	class Module;
@@ -19,6 +21,10 @@ namespace plugify {
 			return _id;
 		}
 
+		void SetId(UniqueId id) noexcept {
+			_id = id;
+		}
+
 		const std::string& GetName() const noexcept {
 			return _name;
 		}
@@ -35,6 +41,10 @@ namespace plugify {
 			return *_descriptor;
 		}
 
+		void SetDescriptor(std::shared_ptr<PluginDescriptor> descriptor) noexcept {
+			_descriptor = std::move(descriptor);
+		}
+
 		PluginState GetState() const noexcept {
 			return _state;
 		}
@@ -47,7 +57,15 @@ namespace plugify {
 			return *_error;
 		}
 
-		std::optional<fs::path_view> FindResource(const fs::path& path) const;
+		const PageFaults& GetPageFaults() const noexcept {
+			return _pageFaults;
+		}
+
+		void SetPageFaults(const PageFaults& pageFaults) noexcept {
+			_pageFaults = pageFaults;
+		}
+
+		std::optional<fs::path_view> FindResource(fs::path_view path) const;
 
 		void SetError(std::string error);
 
@@ -91,8 +109,9 @@ namespace plugify {
 		fs::path _baseDir;
 		std::vector<MethodData> _methods;
 		std::unique_ptr<std::string> _error;
+		PageFaults _pageFaults;
 		std::shared_ptr<PluginDescriptor> _descriptor;
-		std::unordered_map<fs::path, fs::path, path_hash> _resources;
+		std::unique_ptr<ResourceIndex> _resources;
 		std::optional<std::reference_wrapper<Module>> _module;
 		PluginState _state{ PluginState::NotLoaded };
 	};
@@ -14,6 +14,7 @@ namespace plugify {
 		LanguageModuleInfo languageModule;
 		std::vector<PluginReferenceDescriptor> dependencies;
 		std::vector<Method> exportedMethods;
+		bool lazy{false};
 
 	private:
 		mutable std::shared_ptr<std::vector<std::string_view>> _supportedPlatforms;
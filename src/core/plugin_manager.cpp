@@ -7,7 +7,13 @@
 #include <plugify/plugin_descriptor.hpp>
 #include <plugify/plugin_manager.hpp>
 #include <plugify/plugin_reference_descriptor.hpp>
+#include <utils/graph.hpp>
 #include <utils/json.hpp>
+#include <utils/prefetch.hpp>
+#include <utils/thread_pool.hpp>
+#include <utils/trace.hpp>
+
+#include <atomic>
 
 using namespace plugify;
 
@@ -22,15 +28,41 @@ bool PluginManager::Initialize() {
 	if (IsInitialized())
 		return false;
 
+	auto plugify = _plugify.lock();
+	PL_ASSERT(plugify);
+
+	const auto& config = plugify->GetConfig();
+
 	auto debugStart = DateTime::Now();
 
 	DiscoverAllModulesAndPlugins();
+	BuildLookupIndices();
+
+	// Readahead of the binaries overlaps with resource discovery and module initialization
+	std::future<void> prefetch;
+	if (config.prefetchBinaries) {
+		prefetch = PrefetchBinaries();
+	}
+
 	LoadRequiredLanguageModules();
 	LoadAndStartAvailablePlugins();
 
+	if (prefetch.valid()) {
+		prefetch.wait();
+	}
+
 	_inited = true;
 
 	PL_LOG_DEBUG("PluginManager loaded in {}ms", (DateTime::Now() - debugStart).AsMilliseconds<float>());
+
+	if (config.measurePageFaults) {
+		ReportPageFaults(config.parallelLoad);
+	}
+
+	if (TraceSystem::IsEnabled()) {
+		TraceSystem::Write(config.traceFile);
+	}
+
 	return true;
 }
 
@@ -77,24 +109,93 @@ void PluginManager::DiscoverAllModulesAndPlugins() {
 		return;
 	}
 
-	PluginList sortedPlugins;
-	sortedPlugins.reserve(_allPlugins.size());
-	while (!_allPlugins.empty()) {
-		SortPluginsByDependencies(_allPlugins.back()->GetName(), _allPlugins, sortedPlugins);
-	}
+	// The package manager is always the core one, its cache is not a part of the public interface
+	auto packageManager = std::static_pointer_cast<PackageManager>(plugify->GetPackageManager().lock());
 
-	if (HasCyclicDependencies(sortedPlugins)) {
-		PL_LOG_WARNING("Found cyclic dependencies");
+	if (!packageManager || !ApplyLoadOrder(_allPlugins, packageManager->GetCachedLoadOrder())) {
+		// Orders with cycles are not cached, so the warnings are repeated on every run until they are fixed
+		if (SortPluginsByDependencies(_allPlugins) && packageManager) {
+			CacheLoadOrder(*packageManager);
+		}
 	}
 
-	_allPlugins = std::move(sortedPlugins);
-
 	PL_LOG_VERBOSE("Plugins order after topological sorting by dependency: ");
 	for (const auto& plugin : _allPlugins) {
 		PL_LOG_VERBOSE("{} - {}", plugin->GetName(), plugin->GetFriendlyName());
 	}
 }
 
+std::future<void> PluginManager::PrefetchBinaries() const {
+	std::unordered_set<UniqueId> modules;
+	std::set<fs::path> directories;
+
+	for (const auto& plugin : _allPlugins) {
+		const auto& descriptor = plugin->GetDescriptor();
+		auto it = _modulesByLang.find(descriptor.languageModule.name);
+		if (it == _modulesByLang.end())
+			continue;
+		modules.emplace(it->second->GetId());
+
+		// Entry point naming depends on the language module, so the whole directory of the entry point is read ahead
+		fs::path directory = (plugin->GetBaseDir() / descriptor.entryPoint).parent_path();
+		if (directory != plugin->GetBaseDir()) {
+			directories.emplace(std::move(directory));
+		}
+	}
+
+	std::vector<fs::path> files;
+	for (const auto& module : _allModules) {
+		if (module->GetDescriptor().forceLoad || modules.contains(module->GetId())) {
+			files.emplace_back(module->GetFilePath());
+		}
+	}
+
+	return std::async(std::launch::async, [files = std::move(files), directories = std::move(directories)] {
+		PL_TRACE_SCOPE("Prefetch binaries", "discovery", "");
+
+		size_t count = 0;
+		for (const auto& file : files) {
+			count += Prefetcher::Prefetch(file);
+		}
+
+		std::error_code ec;
+		for (const auto& directory : directories) {
+			for (const auto& entry : fs::directory_iterator(directory, ec)) {
+				if (entry.is_regular_file(ec)) {
+					count += Prefetcher::Prefetch(entry.path());
+				}
+			}
+		}
+
+		PL_LOG_VERBOSE("Prefetched {} binaries", count);
+	});
+}
+
+void PluginManager::ReportPageFaults(bool parallelLoad) const {
+	// Without per-thread counters a module's numbers also include whatever the other workers faulted in meanwhile
+	if (parallelLoad && !PageFaults::IsPerThread()) {
+		PL_LOG_INFO("Page faults are counted per process on this platform and modules were loaded in parallel, so the numbers below overlap");
+	}
+
+	for (const auto& module : _allModules) {
+		if (module->GetState() != ModuleState::Loaded)
+			continue;
+
+		PageFaults pluginFaults;
+		size_t pluginCount = 0;
+		for (const auto& plugin : _allPlugins) {
+			auto it = _modulesByLang.find(plugin->GetDescriptor().languageModule.name);
+			if (it != _modulesByLang.end() && it->second == module.get()) {
+				pluginFaults += plugin->GetPageFaults();
+				++pluginCount;
+			}
+		}
+
+		PL_LOG_INFO("Module '{}': {} major / {} minor page faults on initialize, {} major / {} minor while loading {} plugin(s)",
+					module->GetName(), module->GetPageFaults().major, module->GetPageFaults().minor, pluginFaults.major, pluginFaults.minor, pluginCount);
+	}
+}
+
 void PluginManager::LoadRequiredLanguageModules() {
 	if (_allModules.empty())
 		return;
@@ -107,24 +208,49 @@ void PluginManager::LoadRequiredLanguageModules() {
 
 	for (const auto& plugin : _allPlugins) {
 		const auto& lang = plugin->GetDescriptor().languageModule.name;
-		auto it = std::find_if(_allModules.begin(), _allModules.end(), [&lang](const auto& p) {
-			return p->GetLanguage() == lang;
-		});
-		if (it == _allModules.end()) {
+		auto it = _modulesByLang.find(lang);
+		if (it == _modulesByLang.end()) {
 			plugin->SetError(std::format("Language module: '{}' missing for plugin: '{}'", lang, plugin->GetFriendlyName()));
 			continue;
 		}
-		auto& module = *it;
+		Module* module = it->second;
 		plugin->Initialize(plugify->GetProvider());
 		plugin->SetModule(*module);
 		modules.emplace(module->GetId());
 	}
 	
-	bool loadedAny = false;
-
+	std::vector<Module*> requiredModules;
+	requiredModules.reserve(modules.size());
 	for (const auto& module : _allModules) {
 		if (module->GetDescriptor().forceLoad || modules.contains(module->GetId())) {
-			loadedAny |= module->Initialize(plugify->GetProvider());
+			requiredModules.emplace_back(module.get());
+		}
+	}
+
+	auto provider = plugify->GetProvider();
+	bool measurePageFaults = plugify->GetConfig().measurePageFaults;
+
+	// Modules do not depend on each other, so each one gets its own worker when loading in parallel
+	if (plugify->GetConfig().parallelLoad && requiredModules.size() > 1) {
+		ThreadPool threadPool(std::min<size_t>(requiredModules.size(), std::thread::hardware_concurrency()));
+		for (Module* module : requiredModules) {
+			threadPool.Submit([module, &provider, measurePageFaults] { module->Initialize(provider, measurePageFaults); });
+		}
+		threadPool.Wait();
+	} else {
+		for (Module* module : requiredModules) {
+			module->Initialize(provider, measurePageFaults);
+		}
+	}
+
+	bool loadedAny = false;
+
+	// Errors are reported after every module finished, in module order, whatever thread produced them
+	for (Module* module : requiredModules) {
+		if (module->GetState() == ModuleState::Loaded) {
+			loadedAny = true;
+		} else {
+			PL_LOG_ERROR("Module '{}': {}", module->GetName(), module->GetError());
 		}
 	}
 	
@@ -137,54 +263,394 @@ void PluginManager::LoadRequiredLanguageModules() {
 void PluginManager::LoadAndStartAvailablePlugins() {
 	if (_allPlugins.empty())
 		return;
+
+	auto plugify = _plugify.lock();
+	PL_ASSERT(plugify);
+
+	std::unique_ptr<ThreadPool> threadPool;
+	if (plugify->GetConfig().parallelLoad) {
+		threadPool = std::make_unique<ThreadPool>();
+	}
+
+	auto levels = GetDependencyLevels();
+	auto deferred = GetDeferredPlugins();
+
+	std::atomic_bool loadedAny = false;
+
+	RunScheduled(levels, threadPool.get(), [this, &deferred, &loadedAny](Plugin& plugin) {
+		if (plugin.GetState() == PluginState::NotLoaded && !deferred[static_cast<size_t>(plugin.GetId())] && LoadPlugin(plugin)) {
+			loadedAny = true;
+		}
+	});
 	
-	bool loadedAny = false;
-	
+	if (!loadedAny) {
+		PL_LOG_WARNING("Did not load any plugin");
+		return;
+	}
+
+	std::vector<Plugin*> plugins;
+	plugins.reserve(_allPlugins.size());
 	for (const auto& plugin : _allPlugins) {
-		if (plugin->GetState() == PluginState::NotLoaded) {
-			if (plugin->GetModule().GetState() != ModuleState::Loaded) {
-				plugin->SetError(std::format("Language module: '{}' missing", plugin->GetModule().GetFriendlyName()));
-				continue;
+		plugins.emplace_back(plugin.get());
+	}
+	ExportMethods(plugins);
+
+	// Deferred plugins may get activated by a starting plugin, so they are never touched here
+	RunScheduled(levels, threadPool.get(), [this, &deferred](Plugin& plugin) {
+		if (!deferred[static_cast<size_t>(plugin.GetId())]) {
+			StartPlugin(plugin);
+		}
+	});
+}
+
+void PluginManager::CacheLoadOrder(PackageManager& packageManager) const {
+	std::vector<std::string> loadOrder;
+	loadOrder.reserve(_allPlugins.size());
+	for (const auto& plugin : _allPlugins) {
+		loadOrder.emplace_back(plugin->GetName());
+	}
+	packageManager.SetCachedLoadOrder(std::move(loadOrder));
+}
+
+void PluginManager::StartPlugin(Plugin& plugin) {
+	// Serialized with activations, which start the loaded dependencies of a lazy plugin on their own.
+	// The lock is recursive, so a plugin may activate others from its start, it is not started twice then.
+	std::lock_guard lock(_activationMutex);
+
+	if (plugin.GetState() != PluginState::Loaded || std::find(_startingPlugins.begin(), _startingPlugins.end(), &plugin) != _startingPlugins.end())
+		return;
+
+	_startingPlugins.emplace_back(&plugin);
+	plugin.GetModule().StartPlugin(plugin);
+	_startingPlugins.pop_back();
+}
+
+bool PluginManager::LoadPlugin(Plugin& plugin) {
+	if (plugin.GetModule().GetState() != ModuleState::Loaded) {
+		plugin.SetError(std::format("Language module: '{}' missing", plugin.GetModule().GetFriendlyName()));
+		return false;
+	}
+	std::vector<std::string_view> names;
+	for (const auto& descriptor : plugin.GetDescriptor().dependencies) {
+		if (descriptor.optional)
+			continue;
+		// Dependencies outside of a reloaded or activated subgraph are already running
+		auto it = _pluginsByName.find(descriptor.name);
+		if (it == _pluginsByName.end() || (it->second->GetState() != PluginState::Loaded && it->second->GetState() != PluginState::Running)) {
+			names.emplace_back(descriptor.name);
+		}
+	}
+	if (!names.empty()) {
+		std::string error;
+		std::format_to(std::back_inserter(error), "'{}", names[0]);
+		for (auto it = std::next(names.begin()); it != names.end(); ++it) {
+			std::format_to(std::back_inserter(error), "', '{}", *it);
+		}
+		std::format_to(std::back_inserter(error), "'");
+		plugin.SetError(std::format("Not loaded {} dependency plugin(s)", error));
+		return false;
+	}
+	if (!plugin.GetModule().LoadPlugin(plugin))
+		return false;
+	_symbolTable.Register(plugin);
+	return true;
+}
+
+void PluginManager::ExportMethods(std::span<Plugin* const> plugins) const {
+	std::vector<PluginRef> loadedPlugins;
+	loadedPlugins.reserve(plugins.size());
+	for (Plugin* plugin : plugins) {
+		if (plugin->GetState() == PluginState::Loaded) {
+			loadedPlugins.emplace_back(*plugin);
+		}
+	}
+
+	if (loadedPlugins.empty())
+		return;
+
+	// Every module gets the whole pass in one call instead of one call per plugin
+	for (const auto& module : _allModules) {
+		module->MethodExport(loadedPlugins);
+	}
+}
+
+PluginManager::PluginLevels PluginManager::GetDependencyLevels() const {
+	// Plugins are already sorted, so every dependency has its level assigned before its dependents
+	std::unordered_map<std::string_view, size_t> pluginLevels;
+	pluginLevels.reserve(_allPlugins.size());
+
+	PluginLevels levels;
+	for (const auto& plugin : _allPlugins) {
+		size_t level = 0;
+		for (const auto& descriptor : plugin->GetDescriptor().dependencies) {
+			auto it = pluginLevels.find(descriptor.name);
+			if (it != pluginLevels.end()) {
+				level = std::max(level, it->second + 1);
 			}
-			std::vector<std::string_view> names;
-			for (const auto& descriptor : plugin->GetDescriptor().dependencies) {
-				auto dependencyPlugin = FindPlugin(descriptor.name);
-				if ((!dependencyPlugin.has_value() || dependencyPlugin->GetState() != PluginState::Loaded) && !descriptor.optional) {
-					names.emplace_back(descriptor.name);
-				}
+		}
+		pluginLevels.emplace(plugin->GetName(), level);
+		if (level >= levels.size()) {
+			levels.resize(level + 1);
+		}
+		levels[level].emplace_back(plugin.get());
+	}
+	return levels;
+}
+
+std::vector<Plugin*> PluginManager::GetDependentPlugins(const Plugin& plugin) const {
+	// Plugins are sorted, so every dependent comes after the plugin and after each dependency it reaches it through
+	std::unordered_set<std::string_view> names{ plugin.GetName() };
+
+	std::vector<Plugin*> plugins{ _allPlugins[static_cast<size_t>(plugin.GetId())].get() };
+	for (size_t i = static_cast<size_t>(plugin.GetId()) + 1; i < _allPlugins.size(); ++i) {
+		const auto& dependent = _allPlugins[i];
+		for (const auto& descriptor : dependent->GetDescriptor().dependencies) {
+			if (names.contains(descriptor.name)) {
+				names.emplace(dependent->GetName());
+				plugins.emplace_back(dependent.get());
+				break;
 			}
-			if (!names.empty()) {
-				std::string error;
-				std::format_to(std::back_inserter(error), "'{}", names[0]);
-				for (auto it = std::next(names.begin()); it != names.end(); ++it) {
-					std::format_to(std::back_inserter(error), "', '{}", *it);
-				}
-				std::format_to(std::back_inserter(error), "'");
-				plugin->SetError(std::format("Not loaded {} dependency plugin(s)", error));
-			} else {
-				loadedAny |= plugin->GetModule().LoadPlugin(*plugin);
+		}
+	}
+	return plugins;
+}
+
+std::vector<Plugin*> PluginManager::GetDependencyPlugins(const Plugin& plugin) const {
+	// Walk back from the plugin, so every dependency is met after the plugins which require it
+	std::unordered_set<std::string_view> names{ plugin.GetName() };
+
+	std::vector<Plugin*> plugins;
+	for (size_t i = static_cast<size_t>(plugin.GetId()) + 1; i-- > 0;) {
+		const auto& dependency = _allPlugins[i];
+		if (!names.contains(dependency->GetName()))
+			continue;
+		plugins.emplace_back(dependency.get());
+		for (const auto& descriptor : dependency->GetDescriptor().dependencies) {
+			if (!descriptor.optional) {
+				names.emplace(descriptor.name);
 			}
 		}
 	}
-	
-	if (!loadedAny) {
-		PL_LOG_WARNING("Did not load any plugin");
+	std::reverse(plugins.begin(), plugins.end());
+	return plugins;
+}
+
+std::vector<bool> PluginManager::GetDeferredPlugins() const {
+	// Walk back from the last plugin, so lazy plugins required by eager ones are known before they are visited
+	std::unordered_set<std::string_view> required;
+
+	std::vector<bool> deferred(_allPlugins.size());
+	for (size_t i = _allPlugins.size(); i-- > 0;) {
+		const auto& plugin = _allPlugins[i];
+		if (plugin->GetDescriptor().lazy && !required.contains(plugin->GetName())) {
+			deferred[i] = true;
+			continue;
+		}
+		for (const auto& descriptor : plugin->GetDescriptor().dependencies) {
+			if (!descriptor.optional) {
+				required.emplace(descriptor.name);
+			}
+		}
+	}
+	return deferred;
+}
+
+void PluginManager::RunScheduled(const PluginLevels& levels, ThreadPool* threadPool, const std::function<void(Plugin&)>& task) const {
+	if (!threadPool) {
+		for (const auto& plugin : _allPlugins) {
+			task(*plugin);
+		}
 		return;
 	}
 
-	for (const auto& plugin : _allPlugins) {
-		if (plugin->GetState() == PluginState::Loaded) {
-			for (const auto& module : _allModules) {
-				module->MethodExport(*plugin);
+	// Plugins inside one level never depend on each other, so only a barrier between levels is required.
+	// Modules which are not thread-safe still get their plugins one by one on the calling thread.
+	std::vector<Plugin*> serialPlugins;
+	for (const auto& level : levels) {
+		serialPlugins.clear();
+		for (Plugin* plugin : level) {
+			if (plugin->GetState() != PluginState::Error && plugin->GetModule().GetDescriptor().threadSafe) {
+				threadPool->Submit([&task, plugin] { task(*plugin); });
+			} else {
+				serialPlugins.emplace_back(plugin);
 			}
 		}
+		for (Plugin* plugin : serialPlugins) {
+			task(*plugin);
+		}
+		threadPool->Wait();
 	}
+}
 
-	for (const auto& plugin : _allPlugins) {
-		if (plugin->GetState() == PluginState::Loaded) {
-			plugin->GetModule().StartPlugin(*plugin);
+bool PluginManager::ReloadPlugin(std::string_view pluginName) {
+	if (!IsInitialized())
+		return false;
+
+	auto it = _pluginsByName.find(pluginName);
+	if (it == _pluginsByName.end()) {
+		PL_LOG_ERROR("Plugin: '{}' not found", pluginName);
+		return false;
+	}
+
+	Plugin& target = *it->second;
+
+	auto plugify = _plugify.lock();
+	PL_ASSERT(plugify);
+
+	std::lock_guard lock(_activationMutex);
+
+	auto debugStart = DateTime::Now();
+
+	// Read the new descriptor before anything is stopped, so a reload which cannot be applied leaves the plugins running
+	std::shared_ptr<PluginDescriptor> descriptor;
+	if (auto packageManager = plugify->GetPackageManager().lock()) {
+		auto package = packageManager->ReloadLocalPackage(pluginName);
+		if (package.has_value() && package->type == "plugin") {
+			descriptor = std::static_pointer_cast<PluginDescriptor>(package->descriptor);
+		} else {
+			PL_LOG_WARNING("Plugin: '{}' descriptor could not be reloaded, keeping previous one", pluginName);
+		}
+	}
+
+	// Ids are handed out as stable handles and double as load positions, so a dependency has to be ordered before the plugin already
+	if (descriptor) {
+		for (const auto& dependency : descriptor->dependencies) {
+			auto jt = _pluginsByName.find(dependency.name);
+			if (jt != _pluginsByName.end() && jt->second->GetId() > target.GetId()) {
+				PL_LOG_ERROR("Plugin: '{}' cannot be reloaded, new dependency: '{}' is loaded after it, restart to apply the new load order", pluginName, dependency.name);
+				return false;
+			}
+		}
+	}
+
+	auto plugins = GetDependentPlugins(target);
+	std::erase_if(plugins, [](Plugin* plugin) {
+		return plugin->GetState() == PluginState::NotLoaded && plugin->GetDescriptor().lazy;
+	});
+
+	for (auto jt = plugins.rbegin(); jt != plugins.rend(); ++jt) {
+		Plugin* plugin = *jt;
+		if (plugin->GetState() == PluginState::Running) {
+			plugin->GetModule().EndPlugin(*plugin);
+		}
+		_symbolTable.Unregister(*plugin);
+		plugin->Terminate();
+	}
+
+	if (descriptor) {
+		target.SetDescriptor(std::move(descriptor));
+	}
+
+	for (Plugin* plugin : plugins) {
+		const auto& lang = plugin->GetDescriptor().languageModule.name;
+		auto jt = _modulesByLang.find(lang);
+		if (jt == _modulesByLang.end()) {
+			plugin->SetError(std::format("Language module: '{}' missing for plugin: '{}'", lang, plugin->GetFriendlyName()));
+			continue;
+		}
+		plugin->Initialize(plugify->GetProvider());
+		plugin->SetModule(*jt->second);
+	}
+
+	// The new descriptor may also require lazy plugins which were never activated, they are loaded first
+	auto dependencies = GetDependencyPlugins(target);
+	std::erase_if(dependencies, [&target](Plugin* plugin) {
+		return plugin == &target || plugin->GetState() != PluginState::NotLoaded;
+	});
+	plugins.insert(plugins.begin(), dependencies.begin(), dependencies.end());
+
+	for (Plugin* plugin : plugins) {
+		if (plugin->GetState() == PluginState::NotLoaded) {
+			LoadPlugin(*plugin);
+		}
+	}
+
+	ExportMethods(plugins);
+
+	for (Plugin* plugin : plugins) {
+		StartPlugin(*plugin);
+	}
+
+	PL_LOG_DEBUG("Plugin: '{}' reloaded with {} plugin(s) in {}ms", pluginName, plugins.size(), (DateTime::Now() - debugStart).AsMilliseconds<float>());
+	return target.GetState() == PluginState::Running;
+}
+
+bool PluginManager::ActivatePlugin(std::string_view pluginName) {
+	// Not guarded by IsInitialized(), plugins can request lazy ones while the manager is still starting them
+	auto it = _pluginsByName.find(pluginName);
+	if (it == _pluginsByName.end()) {
+		PL_LOG_ERROR("Plugin: '{}' not found", pluginName);
+		return false;
+	}
+
+	Plugin& target = *it->second;
+
+	std::lock_guard lock(_activationMutex);
+
+	if (target.GetState() != PluginState::NotLoaded && target.GetState() != PluginState::Loaded)
+		return target.GetState() == PluginState::Running;
+
+	auto debugStart = DateTime::Now();
+
+	// During the start phase eager dependencies may be loaded, but not started yet, they are started here first
+	auto plugins = GetDependencyPlugins(target);
+	std::erase_if(plugins, [](Plugin* plugin) {
+		return plugin->GetState() != PluginState::NotLoaded && plugin->GetState() != PluginState::Loaded;
+	});
+
+	// Loaded ones were exported by the pass which loaded them
+	std::vector<Plugin*> loadedPlugins;
+	for (Plugin* plugin : plugins) {
+		if (plugin->GetState() == PluginState::NotLoaded && LoadPlugin(*plugin)) {
+			loadedPlugins.emplace_back(plugin);
 		}
 	}
+
+	ExportMethods(loadedPlugins);
+
+	for (Plugin* plugin : plugins) {
+		StartPlugin(*plugin);
+	}
+
+	PL_LOG_DEBUG("Plugin: '{}' activated with {} plugin(s) in {}ms", pluginName, plugins.size(), (DateTime::Now() - debugStart).AsMilliseconds<float>());
+	return target.GetState() == PluginState::Running;
+}
+
+std::optional<MethodData> PluginManager::FindMethod(std::string_view name, uint64_t signature) {
+	auto method = _symbolTable.Find(name, signature);
+	if (!method.has_value() && ActivateMethodOwner(name)) {
+		method = _symbolTable.Find(name, signature);
+	}
+	return method;
+}
+
+size_t PluginManager::ResolveMethods(std::span<const std::string_view> names, std::span<MemAddr> addresses) {
+	size_t resolved = _symbolTable.Find(names, addresses);
+	if (resolved == names.size())
+		return resolved;
+
+	// Only the misses pay for activation of lazy plugins
+	for (size_t i = 0; i < names.size(); ++i) {
+		if (!addresses[i] && ActivateMethodOwner(names[i])) {
+			if (auto method = _symbolTable.Find(names[i])) {
+				addresses[i] = method->second;
+				++resolved;
+			}
+		}
+	}
+	return resolved;
+}
+
+bool PluginManager::ActivateMethodOwner(std::string_view name) {
+	// Method names never contain a dot, so everything before the last one is the plugin name
+	auto pos = name.rfind('.');
+	if (pos == std::string_view::npos)
+		return false;
+	auto pluginName = name.substr(0, pos);
+	auto it = _pluginsByName.find(pluginName);
+	if (it == _pluginsByName.end() || it->second->GetState() != PluginState::NotLoaded)
+		return false;
+	return ActivatePlugin(pluginName);
 }
 
 void PluginManager::TerminateAllPlugins() {
@@ -204,6 +670,8 @@ void PluginManager::TerminateAllPlugins() {
 	}*/
 
 	// Dtor will terminate
+	_symbolTable.Clear();
+	_pluginsByName.clear();
 	_allPlugins.clear();
 }
 
@@ -217,101 +685,126 @@ void PluginManager::TerminateAllModules() {
 	}*/
 
 	// Dtor will terminate
+	_modulesByName.clear();
+	_modulesByLang.clear();
+	_modulesByPath.clear();
 	_allModules.clear();
 }
 
-void PluginManager::SortPluginsByDependencies(const std::string& pluginName, PluginList& sourceList, PluginList& targetList) {
-	auto it = std::find_if(sourceList.begin(), sourceList.end(), [&pluginName](const auto& plugin) {
-		return plugin->GetName() == pluginName;
-	});
-	if (it != sourceList.end()) {
-		auto index = static_cast<size_t>(std::distance(sourceList.begin(), it));
-		auto plugin = std::move(sourceList[index]);
-		sourceList.erase(it);
-		for (const auto& descriptor : plugin->GetDescriptor().dependencies) {
-			SortPluginsByDependencies(descriptor.name, sourceList, targetList);
-		}
-		targetList.emplace_back(std::move(plugin));
+void PluginManager::BuildLookupIndices() {
+	_modulesByName.reserve(_allModules.size());
+	_modulesByLang.reserve(_allModules.size());
+	_modulesByPath.reserve(_allModules.size());
+
+	// First module wins on duplicates, same as the linear search did
+	for (const auto& module : _allModules) {
+		_modulesByName.emplace(module->GetName(), module.get());
+		_modulesByLang.emplace(module->GetLanguage(), module.get());
+		_modulesByPath.emplace(module->GetFilePath(), module.get());
+	}
+
+	_pluginsByName.reserve(_allPlugins.size());
+
+	// Ids follow the load order, so a plugin id is also its index in the list
+	for (size_t i = 0; i < _allPlugins.size(); ++i) {
+		const auto& plugin = _allPlugins[i];
+		plugin->SetId(static_cast<UniqueId>(i));
+		_pluginsByName.emplace(plugin->GetName(), plugin.get());
 	}
 }
 
-bool PluginManager::HasCyclicDependencies(PluginList& plugins) {
-	// Mark all the vertices as not visited
-	// and not part of recursion stack
-	VisitedPluginMap data; /* [visited, recursive] */
+bool PluginManager::ApplyLoadOrder(PluginList& plugins, std::span<const std::string> loadOrder) {
+	if (loadOrder.size() != plugins.size())
+		return false;
+
+	std::unordered_map<std::string_view, size_t> positions;
+	positions.reserve(loadOrder.size());
+	for (size_t i = 0; i < loadOrder.size(); ++i) {
+		positions.emplace(loadOrder[i], i);
+	}
 
-	// Call the recursive helper function
-	// to detect cycle in different DFS trees
+	// Plugin names are unique, so every plugin found in the order also takes a distinct position
 	for (const auto& plugin : plugins) {
-		if (!data[plugin->GetName()].first && IsCyclic(plugin, plugins, data))
-			return true;
+		if (!positions.contains(plugin->GetName()))
+			return false;
+	}
+
+	PluginList sortedPlugins(plugins.size());
+	for (auto& plugin : plugins) {
+		sortedPlugins[positions[plugin->GetName()]] = std::move(plugin);
 	}
 
-	return false;
+	plugins = std::move(sortedPlugins);
+	return true;
 }
 
-bool PluginManager::IsCyclic(const std::unique_ptr<Plugin>& plugin, PluginList& plugins, VisitedPluginMap& visitedPlugins) {
-	auto& [visited, recursive] = visitedPlugins[plugin->GetName()];
-	if (!visited) {
-		// Mark the current node as visited
-		// and part of recursion stack
-		visited = true;
-		recursive = true;
+bool PluginManager::SortPluginsByDependencies(PluginList& plugins) {
+	std::unordered_map<std::string_view, Graph::Node> nodes;
+	nodes.reserve(plugins.size());
+	for (size_t i = 0; i < plugins.size(); ++i) {
+		nodes.emplace(plugins[i]->GetName(), i);
+	}
 
-		// Recur for all the vertices adjacent to this vertex
-		for (const auto& descriptor : plugin->GetDescriptor().dependencies) {
-			const auto& name = descriptor.name;
+	// Edges point from a plugin to its dependencies
+	Graph graph(plugins.size());
+	for (size_t i = 0; i < plugins.size(); ++i) {
+		for (const auto& descriptor : plugins[i]->GetDescriptor().dependencies) {
+			auto it = nodes.find(descriptor.name);
+			if (it != nodes.end()) {
+				graph.AddEdge(i, it->second);
+			}
+		}
+	}
+
+	PluginList sortedPlugins;
+	sortedPlugins.reserve(plugins.size());
 
-			auto it = std::find_if(plugins.begin(), plugins.end(), [&name](const auto& p) {
-				return p->GetName() == name;
-			});
+	bool acyclic = true;
 
-			if (it != plugins.end()) {
-				const auto& [vis, rec] = visitedPlugins[name];
-				if ((!vis && IsCyclic(*it, plugins, visitedPlugins)) || rec)
-					return true;
+	for (const auto& component : graph.GetStronglyConnectedComponents()) {
+		if (graph.IsCyclic(component)) {
+			acyclic = false;
+			std::string error;
+			std::format_to(std::back_inserter(error), "'{}", plugins[component[0]]->GetName());
+			for (auto it = std::next(component.begin()); it != component.end(); ++it) {
+				std::format_to(std::back_inserter(error), "', '{}", plugins[*it]->GetName());
 			}
+			std::format_to(std::back_inserter(error), "'");
+			PL_LOG_WARNING("Found cyclic dependencies between {} plugin(s)", error);
+		}
+		for (Graph::Node node : component) {
+			sortedPlugins.emplace_back(std::move(plugins[node]));
 		}
 	}
 
-	// Remove the vertex from recursion stack
-	recursive = false;
-	return false;
+	plugins = std::move(sortedPlugins);
+	return acyclic;
 }
 
 ModuleOpt PluginManager::FindModule(std::string_view moduleName) const {
-	auto it = std::find_if(_allModules.begin(), _allModules.end(), [&moduleName](const auto& module) {
-		return module->GetName() == moduleName;
-	});
-	if (it != _allModules.end())
-		return *(*it);
+	auto it = _modulesByName.find(moduleName);
+	if (it != _modulesByName.end())
+		return *it->second;
 	return {};
 }
 
 ModuleOpt PluginManager::FindModuleFromId(UniqueId moduleId) const {
-	auto it = std::find_if(_allModules.begin(), _allModules.end(), [&moduleId](const auto& module) {
-		return module->GetId() == moduleId;
-	});
-	if (it != _allModules.end())
-		return *(*it);
-	return {};
+	if (moduleId < 0 || static_cast<size_t>(moduleId) >= _allModules.size())
+		return {};
+	return *_allModules[static_cast<size_t>(moduleId)];
 }
 
 ModuleOpt PluginManager::FindModuleFromLang(std::string_view moduleLang) const {
-	auto it = std::find_if(_allModules.begin(), _allModules.end(), [&moduleLang](const auto& module) {
-		return module->GetLanguage() == moduleLang;
-	});
-	if (it != _allModules.end())
-		return *(*it);
+	auto it = _modulesByLang.find(moduleLang);
+	if (it != _modulesByLang.end())
+		return *it->second;
 	return {};
 }
 
 ModuleOpt PluginManager::FindModuleFromPath(const fs::path& moduleFilePath) const {
-	auto it = std::find_if(_allModules.begin(), _allModules.end(), [&moduleFilePath](const auto& module) {
-		return module->GetFilePath() == moduleFilePath;
-	});
-	if (it != _allModules.end())
-		return *(*it);
+	auto it = _modulesByPath.find(moduleFilePath);
+	if (it != _modulesByPath.end())
+		return *it->second;
 	return {};
 }
 
@@ -325,32 +818,27 @@ std::vector<ModuleRef> PluginManager::GetModules() const {
 }
 
 PluginOpt PluginManager::FindPlugin(std::string_view pluginName) const {
-	auto it = std::find_if(_allPlugins.begin(), _allPlugins.end(), [&pluginName](const auto& plugin) {
-		return plugin->GetName() == pluginName;
-	});
-	if (it != _allPlugins.end())
-		return *(*it);
+	auto it = _pluginsByName.find(pluginName);
+	if (it != _pluginsByName.end())
+		return *it->second;
 	return {};
 }
 
 PluginOpt PluginManager::FindPluginFromId(UniqueId pluginId) const {
-	auto it = std::find_if(_allPlugins.begin(), _allPlugins.end(), [&pluginId](const auto& plugin) {
-		return plugin->GetId() == pluginId;
-	});
-	if (it != _allPlugins.end())
-		return *(*it);
-	return {};
+	if (pluginId < 0 || static_cast<size_t>(pluginId) >= _allPlugins.size())
+		return {};
+	return *_allPlugins[static_cast<size_t>(pluginId)];
 }
 
 PluginOpt PluginManager::FindPluginFromDescriptor(const PluginReferenceDescriptorRef& pluginDescriptor) const {
-	auto name = pluginDescriptor.GetName();
+	auto it = _pluginsByName.find(pluginDescriptor.GetName());
+	if (it == _pluginsByName.end())
+		return {};
+	const Plugin& plugin = *it->second;
 	auto version = pluginDescriptor.GetRequestedVersion();
-	auto it = std::find_if(_allPlugins.begin(), _allPlugins.end(), [&name, &version](const auto& plugin) {
-		return plugin->GetName() == name && (!version || plugin->GetDescriptor().version == version);
-	});
-	if (it != _allPlugins.end())
-		return *(*it);
-	return {};
+	if (version && plugin.GetDescriptor().version != version)
+		return {};
+	return plugin;
 }
 
 std::vector<PluginRef> PluginManager::GetPlugins() const {
@@ -1,14 +1,20 @@
 #pragma once
 
 #include "plugify_context.hpp"
+#include "symbol_table.hpp"
 #include <plugify/language_module.hpp>
 #include <plugify/plugin.hpp>
 #include <plugify/plugin_manager.hpp>
+#include <utils/hash.hpp>
+
+#include <future>
 
 namespace plugify {
 	class Plugin;
 	class Module;
+	class PackageManager;
 	class IPlugify;
+	class ThreadPool;
 
 	class PluginManager final : public IPluginManager, public PlugifyContext {
 	public:
@@ -32,24 +38,54 @@ namespace plugify {
 		PluginOpt FindPluginFromDescriptor(const PluginReferenceDescriptorRef& pluginDescriptor) const override;
 		std::vector<PluginRef> GetPlugins() const override;
 
+		bool ReloadPlugin(std::string_view pluginName) override;
+		bool ActivatePlugin(std::string_view pluginName) override;
+
+		std::optional<MethodData> FindMethod(std::string_view name, uint64_t signature = 0);
+		size_t ResolveMethods(std::span<const std::string_view> names, std::span<MemAddr> addresses);
+
 	private:
 		using PluginList = std::vector<std::unique_ptr<Plugin>>;
 		using ModuleList = std::vector<std::unique_ptr<Module>>;
-		using VisitedPluginMap = std::unordered_map<std::string, std::pair<bool, bool>>;
+		using PluginLevels = std::vector<std::vector<Plugin*>>;
+		template<typename T>
+		using NameIndex = std::unordered_map<std::string, T*, string_hash, std::equal_to<>>;
+		template<typename T>
+		using PathIndex = std::unordered_map<fs::path, T*, path_hash>;
 
 		void DiscoverAllModulesAndPlugins();
+		void BuildLookupIndices();
 		void LoadRequiredLanguageModules();
 		void LoadAndStartAvailablePlugins();
 		void TerminateAllPlugins();
 		void TerminateAllModules();
+		std::future<void> PrefetchBinaries() const;
+		void ReportPageFaults(bool parallelLoad) const;
+
+		void CacheLoadOrder(PackageManager& packageManager) const;
+		bool LoadPlugin(Plugin& plugin);
+		void StartPlugin(Plugin& plugin);
+		bool ActivateMethodOwner(std::string_view name);
+		void ExportMethods(std::span<Plugin* const> plugins) const;
+		PluginLevels GetDependencyLevels() const;
+		std::vector<Plugin*> GetDependentPlugins(const Plugin& plugin) const;
+		std::vector<Plugin*> GetDependencyPlugins(const Plugin& plugin) const;
+		std::vector<bool> GetDeferredPlugins() const;
+		void RunScheduled(const PluginLevels& levels, ThreadPool* threadPool, const std::function<void(Plugin&)>& task) const;
 
-		static void SortPluginsByDependencies(const std::string& pluginName, PluginList& sourceList, PluginList& targetList);
-		static bool HasCyclicDependencies(PluginList& plugins);
-		static bool IsCyclic(const std::unique_ptr<Plugin>& plugin, PluginList& plugins, VisitedPluginMap& visitedPlugins);
+		static bool ApplyLoadOrder(PluginList& plugins, std::span<const std::string> loadOrder);
+		static bool SortPluginsByDependencies(PluginList& plugins);
 
 	private:
 		ModuleList _allModules;
 		PluginList _allPlugins;
+		NameIndex<Module> _modulesByName;
+		NameIndex<Module> _modulesByLang;
+		PathIndex<Module> _modulesByPath;
+		NameIndex<Plugin> _pluginsByName;
+		SymbolTable _symbolTable;
+		std::recursive_mutex _activationMutex;
+		std::vector<Plugin*> _startingPlugins;
 		bool _inited{ false };
 	};
 }
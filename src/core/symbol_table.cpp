@@ -0,0 +1,73 @@
+#include "symbol_table.hpp"
+#include "plugin.hpp"
+
+using namespace plugify;
+
+bool SymbolTable::Register(const Plugin& plugin) {
+	std::unique_lock lock(_mutex);
+
+	bool registered = true;
+	for (const auto& [method, addr] : plugin.GetMethods()) {
+		auto [it, result] = _symbols.try_emplace(MakeName(plugin.GetName(), method.GetName()), Symbol{ MethodData{ method, addr }, method.GetSignatureHash() });
+		if (!result) {
+			PL_LOG_WARNING("Method: '{}' already exported, second export will be ignored", std::get<const std::string>(*it));
+			registered = false;
+		}
+	}
+	return registered;
+}
+
+void SymbolTable::Unregister(const Plugin& plugin) {
+	std::unique_lock lock(_mutex);
+
+	for (const auto& [method, _] : plugin.GetMethods()) {
+		auto it = _symbols.find(MakeName(plugin.GetName(), method.GetName()));
+		if (it != _symbols.end()) {
+			_symbols.erase(it);
+		}
+	}
+}
+
+void SymbolTable::Clear() {
+	std::unique_lock lock(_mutex);
+	_symbols.clear();
+}
+
+std::optional<MethodData> SymbolTable::Find(std::string_view name, uint64_t signature) const {
+	std::shared_lock lock(_mutex);
+
+	auto it = _symbols.find(name);
+	if (it == _symbols.end())
+		return {};
+	const auto& symbol = std::get<Symbol>(*it);
+	if (signature && symbol.signature != signature)
+		return {};
+	return symbol.method;
+}
+
+size_t SymbolTable::Find(std::span<const std::string_view> names, std::span<MemAddr> addresses) const {
+	PL_ASSERT(names.size() == addresses.size(), "Every name should have an address slot");
+
+	std::shared_lock lock(_mutex);
+
+	size_t resolved = 0;
+	for (size_t i = 0; i < names.size(); ++i) {
+		auto it = _symbols.find(names[i]);
+		if (it != _symbols.end()) {
+			addresses[i] = std::get<Symbol>(*it).method.second;
+			++resolved;
+		} else {
+			addresses[i] = {};
+		}
+	}
+	return resolved;
+}
+
+std::string SymbolTable::MakeName(std::string_view pluginName, std::string_view methodName) {
+	std::string name;
+	name.reserve(pluginName.size() + methodName.size() + 1);
+	name.append(pluginName);
+	name.push_back('.');
+	name.append(methodName);
+	return name;
+}
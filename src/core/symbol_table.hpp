@@ -0,0 +1,32 @@
+#pragma once
+
+#include <plugify/method.hpp>
+#include <plugify/plugin.hpp>
+#include <utils/hash.hpp>
+
+#include <shared_mutex>
+
+namespace plugify {
+	class Plugin;
+
+	class SymbolTable {
+	public:
+		bool Register(const Plugin& plugin);
+		void Unregister(const Plugin& plugin);
+		void Clear();
+
+		std::optional<MethodData> Find(std::string_view name, uint64_t signature = 0) const;
+		size_t Find(std::span<const std::string_view> names, std::span<MemAddr> addresses) const;
+
+		static std::string MakeName(std::string_view pluginName, std::string_view methodName);
+
+	private:
+		struct Symbol {
+			MethodData method;
+			uint64_t signature;
+		};
+
+		std::unordered_map<std::string, Symbol, string_hash, std::equal_to<>> _symbols;
+		mutable std::shared_mutex _mutex;
+	};
+}
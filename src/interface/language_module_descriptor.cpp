@@ -92,3 +92,11 @@ std::string_view LanguageModuleDescriptorRef::GetLanguage() const noexcept {
 bool LanguageModuleDescriptorRef::IsForceLoad() const noexcept {
 	return _impl->forceLoad;
 }
+
+bool LanguageModuleDescriptorRef::IsThreadSafe() const noexcept {
+	return _impl->threadSafe;
+}
+
+bool LanguageModuleDescriptorRef::IsBatchMethodExport() const noexcept {
+	return _impl->batchMethodExport;
+}
@@ -51,6 +51,10 @@ uint8_t MethodRef::GetVarIndex() const noexcept {
 	return _impl->varIndex;
 }
 
+uint64_t MethodRef::GetSignatureHash() const noexcept {
+	return _impl->GetSignatureHash();
+}
+
 std::optional<MethodRef> MethodRef::FindPrototype(std::string_view name) const noexcept {
 	auto prototype = _impl->FindPrototype(name);
 	if (prototype) {
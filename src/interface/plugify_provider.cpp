@@ -22,3 +22,15 @@ bool IPlugifyProvider::IsPluginLoaded(std::string_view name, std::optional<int32
 bool IPlugifyProvider::IsModuleLoaded(std::string_view name, std::optional<int32_t> requiredVersion, bool minimum) const noexcept {
 	return _impl->IsModuleLoaded(name, requiredVersion, minimum);
 }
+
+MemAddr IPlugifyProvider::ResolveMethod(std::string_view pluginName, std::string_view methodName) const {
+	return _impl->ResolveMethod(pluginName, methodName);
+}
+
+std::optional<MethodData> IPlugifyProvider::FindMethod(std::string_view name, uint64_t signature) const {
+	return _impl->FindMethod(name, signature);
+}
+
+size_t IPlugifyProvider::ResolveMethods(std::span<const std::string_view> names, std::span<MemAddr> addresses) const {
+	return _impl->ResolveMethods(names, addresses);
+}
@@ -101,3 +101,7 @@ std::span<const MethodRef> PluginDescriptorRef::GetExportedMethods() const noexc
 		return {};
 	}
 }
+
+bool PluginDescriptorRef::IsLazy() const noexcept {
+	return _impl->lazy;
+}
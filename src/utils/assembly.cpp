@@ -1,19 +1,20 @@
 #include <plugify/assembly.hpp>
 
-#include <array>
-#include <cmath>
-#include <cstring>
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <thread>
 
-#if !PLUGIFY_ARCH_ARM
-#if PLUGIFY_COMPILER_GCC && !PLUGIFY_COMPILER_CLANG && !defined(NDEBUG)
-#undef __OPTIMIZE__
-#endif // !defined(NDEBUG)
-#include <emmintrin.h>
-#endif // !PLUGIFY_USE_ARM
+#include "pattern_scanner.hpp"
+#include "scan_cache.hpp"
+#include "vtable_index.hpp"
 
 using namespace plugify;
 namespace fs = std::filesystem;
 
+Assembly::Assembly() : _handle{nullptr} {
+}
+
 Assembly::Assembly(std::string_view moduleName, LoadFlag flags, const SearchDirs& additionalSearchDirectories, bool sections) : _handle{nullptr} {
 	InitFromName(moduleName, flags, additionalSearchDirectories, sections);
 }
@@ -50,94 +51,351 @@ std::pair<std::vector<uint8_t>, std::string> Assembly::PatternToMaskedBytes(std:
 	return std::make_pair(std::move(bytes), std::move(mask));
 }
 
-MemAddr Assembly::FindPattern(MemAddr pattern, std::string_view mask, MemAddr startAddress, Section* moduleSection) const {
-	const uint8_t* pPattern = pattern.RCast<const uint8_t*>();
+namespace {
+	struct ScanCacheSettings {
+		std::mutex mutex;
+		fs::path directory;
+	};
+
+	ScanCacheSettings& GetScanCacheSettings() {
+		static ScanCacheSettings settings;
+		return settings;
+	}
+
+	enum class ScanKind : uint8_t {
+		Pattern = 1,
+		VirtualTable = 2,
+	};
+
+	uint64_t GetKindHash(ScanKind kind) noexcept {
+		const auto value = static_cast<uint8_t>(kind);
+		return ScanCache::GetHash(std::span(&value, 1));
+	}
+
+	// Wildcard bytes do not take part, the scanned range is part of the key as offsets from the module base
+	uint64_t GetPatternKey(const uint8_t* bytes, std::string_view mask, uint64_t sectionOffset, uint64_t sectionSize, uint64_t startOffset) noexcept {
+		uint64_t hash = GetKindHash(ScanKind::Pattern);
+		for (size_t i = 0; i < mask.size(); ++i) {
+			const bool fixed = mask[i] == 'x';
+			const uint8_t pair[] = { fixed ? bytes[i] : uint8_t{0}, static_cast<uint8_t>(fixed) };
+			hash = ScanCache::GetHash(pair, hash);
+		}
+		const uint64_t range[] = { sectionOffset, sectionSize, startOffset };
+		return ScanCache::GetHash(std::span(reinterpret_cast<const uint8_t*>(range), sizeof(range)), hash);
+	}
+
+	// A cached address is only used when it is inside the scanned range and the pattern still matches there
+	bool IsPatternAt(const uint8_t* address, const uint8_t* bytes, std::string_view mask, const uint8_t* begin, const uint8_t* end) noexcept {
+		if (address < begin || address > end || static_cast<size_t>(end - address) < mask.size())
+			return false;
+		for (size_t i = 0; i < mask.size(); ++i) {
+			if (mask[i] == 'x' && address[i] != bytes[i])
+				return false;
+		}
+		return true;
+	}
+}
+
+std::pair<const uint8_t*, const uint8_t*> Assembly::GetScanRange(MemAddr startAddress, const Section* moduleSection) const {
+	InitSections();
+
 	const Section* section = moduleSection ? moduleSection : &_executableCode;
 	if (!section->IsValid())
-		return nullptr;
+		return {};
 
-	const uintptr_t base = section->base;
-	const size_t size = section->size;
-
-	const size_t maskLen = mask.length();
-	const uint8_t* pData = reinterpret_cast<uint8_t*>(base);
-	const uint8_t* pEnd = pData + size - maskLen;
+	const uint8_t* pData = section->base.RCast<const uint8_t*>();
+	const uint8_t* pEnd = pData + section->size;
 
 	if (startAddress) {
-		const uint8_t* pStartAddress = startAddress.RCast<uint8_t*>();
+		const uint8_t* pStartAddress = startAddress.RCast<const uint8_t*>();
 		if (pData > pStartAddress || pStartAddress > pEnd)
-			return nullptr;
+			return {};
 
 		pData = pStartAddress;
 	}
 
-#if !PLUGIFY_ARCH_ARM
-	std::array<int, 64> masks = {};// 64*16 = enough masks for 1024 bytes.
-	const uint8_t numMasks = static_cast<uint8_t>(std::ceil(static_cast<float>(maskLen) / 16.f));
+	return { pData, pEnd };
+}
 
-	for (uint8_t i = 0; i < numMasks; ++i) {
-		for (int8_t j = static_cast<int8_t>(std::min<size_t>(maskLen - i * 16, 16)) - 1; j >= 0; --j) {
-			if (mask[static_cast<size_t>(i * 16 + j)] == 'x') {
-				masks[i] |= 1 << j;
-			}
-		}
+MemAddr Assembly::ScanPattern(MemAddr pattern, std::string_view mask, MemAddr startAddress, const Section* moduleSection, size_t threadCount) const {
+	const auto [pData, pEnd] = GetScanRange(startAddress, moduleSection);
+	if (!pData)
+		return nullptr;
+
+	const Pattern compiled(std::span(pattern.RCast<const uint8_t*>(), mask.length()), mask);
+	if (threadCount > 1)
+		return compiled.FindParallel(pData, pEnd, threadCount);
+	return compiled.Find(pData, pEnd);
+}
+
+MemAddr Assembly::FindPattern(MemAddr pattern, std::string_view mask, MemAddr startAddress, Section* moduleSection) const {
+	return LookupPattern(pattern, mask, startAddress, moduleSection, 1);
+}
+
+MemAddr Assembly::FindPattern(const ParallelScan& policy, MemAddr pattern, std::string_view mask, MemAddr startAddress, Section* moduleSection) const {
+	const size_t threadCount = policy.threadCount ? policy.threadCount : std::thread::hardware_concurrency();
+	return LookupPattern(pattern, mask, startAddress, moduleSection, std::max<size_t>(threadCount, 1));
+}
+
+MemAddr Assembly::FindPattern(const ParallelScan& policy, std::string_view pattern, MemAddr startAddress, Section* moduleSection) const {
+	const std::pair patternInfo = PatternToMaskedBytes(pattern);
+	return FindPattern(policy, patternInfo.first.data(), patternInfo.second, startAddress, moduleSection);
+}
+
+MemAddr Assembly::LookupPattern(MemAddr pattern, std::string_view mask, MemAddr startAddress, const Section* moduleSection, size_t threadCount) const {
+	ScanCache* cache = GetScanCache();
+	if (!cache)
+		return ScanPattern(pattern, mask, startAddress, moduleSection, threadCount);
+
+	const auto [pBegin, pEnd] = GetScanRange(startAddress, moduleSection);
+	if (!pBegin)
+		return nullptr;
+
+	const Section* section = moduleSection ? moduleSection : &_executableCode;
+	const uintptr_t base = GetBase();
+	const auto* bytes = pattern.RCast<const uint8_t*>();
+
+	const uint64_t key = GetPatternKey(bytes, mask, section->base.GetPtr() - base, section->size, startAddress ? startAddress.GetPtr() - base : 0);
+	if (auto entry = cache->Find(key)) {
+		const auto* address = reinterpret_cast<const uint8_t*>(base + entry->offset);
+		if (IsPatternAt(address, bytes, mask, pBegin, pEnd))
+			return address;
+		cache->Remove(key);
 	}
 
-	const __m128i xmm1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPattern));
-	__m128i xmm2, xmm3, msks;
-	for (; pData != pEnd; _mm_prefetch(reinterpret_cast<const char*>(++pData + 64), _MM_HINT_NTA)) {
-		xmm2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData));
-		msks = _mm_cmpeq_epi8(xmm1, xmm2);
-		if ((_mm_movemask_epi8(msks) & masks[0]) == masks[0]) {
-			bool found = true;
-			for (uint8_t i = 1; i < numMasks; ++i) {
-				xmm2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>((pData + i * 16)));
-				xmm3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>((pPattern + i * 16)));
-				msks = _mm_cmpeq_epi8(xmm2, xmm3);
-				if ((_mm_movemask_epi8(msks) & masks[i]) != masks[i]) {
-					found = false;
-					break;
+	MemAddr address = ScanPattern(pattern, mask, startAddress, section, threadCount);
+	if (address) {
+		cache->Store(key, { address.GetPtr() - base, 0 });
+	}
+	return address;
+}
+
+MemAddr Assembly::FindPattern(std::string_view pattern, MemAddr startAddress, Section* moduleSection) const {
+	const std::pair patternInfo = PatternToMaskedBytes(pattern);
+	return FindPattern(patternInfo.first.data(), patternInfo.second, startAddress, moduleSection);
+}
+
+Assembly::PatternRange Assembly::FindAllPatterns(MemAddr pattern, std::string_view mask, MemAddr startAddress, Section* moduleSection) const {
+	const auto [pData, pEnd] = GetScanRange(startAddress, moduleSection);
+	if (!pData)
+		return {};
+
+	auto compiled = std::make_unique<Pattern>(std::span(pattern.RCast<const uint8_t*>(), mask.length()), mask);
+	return { std::move(compiled), pData, pEnd };
+}
+
+Assembly::PatternRange Assembly::FindAllPatterns(std::string_view pattern, MemAddr startAddress, Section* moduleSection) const {
+	const std::pair patternInfo = PatternToMaskedBytes(pattern);
+	return FindAllPatterns(patternInfo.first.data(), patternInfo.second, startAddress, moduleSection);
+}
+
+size_t Assembly::CountPattern(MemAddr pattern, std::string_view mask, size_t limit, Section* moduleSection) const {
+	const auto [pData, pEnd] = GetScanRange(nullptr, moduleSection);
+	if (!pData)
+		return 0;
+
+	const Pattern compiled(std::span(pattern.RCast<const uint8_t*>(), mask.length()), mask);
+	return compiled.Count(pData, pEnd, limit);
+}
+
+size_t Assembly::CountPattern(std::string_view pattern, size_t limit, Section* moduleSection) const {
+	const std::pair patternInfo = PatternToMaskedBytes(pattern);
+	return CountPattern(patternInfo.first.data(), patternInfo.second, limit, moduleSection);
+}
+
+Assembly::PatternRange::PatternRange() noexcept = default;
+
+Assembly::PatternRange::PatternRange(std::unique_ptr<Pattern> pattern, const uint8_t* begin, const uint8_t* end) noexcept
+	: _pattern{std::move(pattern)}, _begin{begin}, _end{end} {
+}
+
+Assembly::PatternRange::~PatternRange() = default;
+
+Assembly::PatternRange::PatternRange(PatternRange&& other) noexcept = default;
+
+Assembly::PatternRange& Assembly::PatternRange::operator=(PatternRange&& other) noexcept = default;
+
+Assembly::PatternRange::Iterator Assembly::PatternRange::begin() const {
+	if (!_pattern)
+		return {};
+	return { this, _pattern->Find(_begin, _end) };
+}
+
+Assembly::PatternRange::Iterator& Assembly::PatternRange::Iterator::operator++() {
+	// The next match may overlap the current one
+	_current = _range->_pattern->Find(_current + 1, _range->_end);
+	return *this;
+}
+
+std::vector<MemAddr> Assembly::FindPatterns(std::span<const std::string_view> patterns, Section* moduleSection) const {
+	InitSections();
+
+	std::vector<MemAddr> addresses(patterns.size(), nullptr);
+
+	const Section* section = moduleSection ? moduleSection : &_executableCode;
+	if (!section->IsValid())
+		return addresses;
+
+	ScanCache* cache = GetScanCache();
+	const uintptr_t base = GetBase();
+	const uint8_t* pData = section->base.RCast<const uint8_t*>();
+	const uint8_t* pEnd = pData + section->size;
+
+	// Patterns with a valid cached address are left out of the scan
+	std::vector<Pattern> compiled;
+	std::vector<size_t> scanned;
+	std::vector<uint64_t> keys;
+	for (size_t i = 0; i < patterns.size(); ++i) {
+		const auto [bytes, mask] = PatternToMaskedBytes(patterns[i]);
+		if (cache) {
+			const uint64_t key = GetPatternKey(bytes.data(), mask, section->base.GetPtr() - base, section->size, 0);
+			if (auto entry = cache->Find(key)) {
+				const auto* address = reinterpret_cast<const uint8_t*>(base + entry->offset);
+				if (IsPatternAt(address, bytes.data(), mask, pData, pEnd)) {
+					addresses[i] = address;
+					continue;
 				}
+				cache->Remove(key);
 			}
+			keys.push_back(key);
+		}
+		compiled.emplace_back(bytes, mask);
+		scanned.push_back(i);
+	}
+
+	if (compiled.empty())
+		return addresses;
 
-			if (found)
-				return pData;
+	const PatternSet patternSet(std::move(compiled));
+	const auto found = patternSet.FindFirst(pData, pEnd);
+	for (size_t i = 0; i < found.size(); ++i) {
+		addresses[scanned[i]] = found[i];
+		if (cache && found[i]) {
+			cache->Store(keys[i], { reinterpret_cast<uintptr_t>(found[i]) - base, 0 });
 		}
 	}
-#else
-	for (; pData != pEnd; ++pData) {
-		bool found = false;
-
-		for (size_t i = 0; i < maskLen; ++i) {
-			if (mask[i] == 'x' || pPattern[i] == *(pData + i)) {
-				found = true;
-			} else {
-				found = false;
-				break;
-			}
+	return addresses;
+}
+
+MemAddr Assembly::GetVirtualTableByName(std::string_view tableName, bool decorated) const {
+	ScanCache* cache = GetScanCache();
+	if (!cache || tableName.empty())
+		return FindVirtualTable(tableName, decorated);
+
+	InitSections();
+
+	// The slot before the table points to the type information (Itanium) or the complete object locator (MSVC),
+	// both are a part of the module, so its offset from the base is the same on every run of the same binary
+	const uintptr_t base = GetBase();
+	auto getCheck = [&](uintptr_t table) -> std::optional<uint64_t> {
+		const uintptr_t slot = table - sizeof(uintptr_t);
+		for (const auto& section : _sections) {
+			if (slot >= section.base.GetPtr() && slot + sizeof(uintptr_t) <= section.base.GetPtr() + section.size)
+				return MemAddr(slot).GetValue<uintptr_t>() - base;
 		}
+		return std::nullopt;
+	};
 
-		if (found)
-			return pData;
+	const uint8_t flag = decorated;
+	const uint64_t key = ScanCache::GetHash(std::span(&flag, 1), ScanCache::GetHash(tableName, GetKindHash(ScanKind::VirtualTable)));
+	if (auto entry = cache->Find(key)) {
+		const uintptr_t table = base + entry->offset;
+		if (getCheck(table) == entry->check)
+			return table;
+		cache->Remove(key);
 	}
-#endif // !PLUGIFY_ARCH_ARM
-	return nullptr;
+
+	MemAddr table = FindVirtualTable(tableName, decorated);
+	if (table) {
+		if (auto check = getCheck(table)) {
+			cache->Store(key, { table.GetPtr() - base, *check });
+		}
+	}
+	return table;
 }
 
-MemAddr Assembly::FindPattern(std::string_view pattern, MemAddr startAddress, Section* moduleSection) const {
-	const std::pair patternInfo = PatternToMaskedBytes(pattern);
-	return FindPattern(patternInfo.first.data(), patternInfo.second, startAddress, moduleSection);
+void Assembly::SetScanCacheDirectory(fs::path directory) {
+	auto& settings = GetScanCacheSettings();
+	std::lock_guard lock(settings.mutex);
+	settings.directory = std::move(directory);
 }
 
-Assembly::Section Assembly::GetSectionByName(std::string_view sectionName) const noexcept {
-	for (const Section& section : _sections) {
-		if (section.name == sectionName)
-			return section;
+ScanCache* Assembly::GetScanCache() const {
+	std::call_once(_scanCacheFlag, [this] {
+		fs::path directory;
+		{
+			auto& settings = GetScanCacheSettings();
+			std::lock_guard lock(settings.mutex);
+			directory = settings.directory;
+		}
+		if (directory.empty() || !_handle)
+			return;
+
+		// Without a build id the whole file is hashed, which is still far cheaper than the scans it saves
+		std::string identity = GetBuildId();
+		if (identity.empty()) {
+			const uint64_t hash = _path.empty() ? 0 : ScanCache::GetFileHash(_path);
+			if (!hash)
+				return;
+			constexpr char kDigits[] = "0123456789abcdef";
+			for (int shift = 60; shift >= 0; shift -= 4) {
+				identity += kDigits[(hash >> shift) & 0xF];
+			}
+		}
+
+		std::error_code ec;
+		fs::create_directories(directory, ec);
+		_scanCache = std::make_unique<ScanCache>(directory / (_path.stem().string() + "-" + identity + ScanCache::kExtension));
+	});
+	return _scanCache.get();
+}
+
+#if !PLUGIFY_PLATFORM_LINUX || PLUGIFY_PLATFORM_ANDROID
+std::vector<MemAddr> Assembly::GetFunctionsByName(std::span<const std::string_view> functionNames) const {
+	std::vector<MemAddr> addresses;
+	addresses.reserve(functionNames.size());
+	for (const auto& functionName : functionNames) {
+		addresses.emplace_back(GetFunctionByName(std::string(functionName)));
 	}
+	return addresses;
+}
+#endif // !PLUGIFY_PLATFORM_LINUX || PLUGIFY_PLATFORM_ANDROID
+
+Assembly::Section Assembly::GetSectionByName(std::string_view sectionName) const noexcept {
+	InitSections();
+
+	auto it = std::lower_bound(_sections.begin(), _sections.end(), sectionName, [](const Section& section, std::string_view name) {
+		return section.name < name;
+	});
+	if (it != _sections.end() && it->name == sectionName)
+		return *it;
 
 	return {};
 }
 
+void Assembly::InitSections() const {
+	std::call_once(_sectionsFlag, [this] {
+		LoadSections();
+		// Stable, so the first one of several sections with the same name is still found
+		std::stable_sort(_sections.begin(), _sections.end(), [](const Section& lhs, const Section& rhs) {
+			return lhs.name < rhs.name;
+		});
+	});
+}
+
+#if !PLUGIFY_PLATFORM_LINUX
+std::string Assembly::GetBuildId() const {
+	// Only ELF images carry a build id note
+	return {};
+}
+#endif // !PLUGIFY_PLATFORM_LINUX
+
+#if !PLUGIFY_PLATFORM_LINUX || PLUGIFY_PLATFORM_ANDROID
+void Assembly::LoadSections() const {
+	// Sections are read by Init on the other platforms
+}
+#endif // !PLUGIFY_PLATFORM_LINUX || PLUGIFY_PLATFORM_ANDROID
+
 void* Assembly::GetHandle() const noexcept {
 	return _handle;
 }
@@ -151,6 +409,10 @@ const std::string& Assembly::GetError() const noexcept {
 }
 
 #if PLUGIFY_SEPARATE_SOURCE_FILES
+#include "pattern_scanner.cpp"
+#include "scan_cache.cpp"
+#include "thread_pool.cpp"
+#include "vtable_index.cpp"
 #if PLUGIFY_PLATFORM_WINDOWS
 #include "assembly_windows.cpp"
 #elif PLUGIFY_PLATFORM_LINUX
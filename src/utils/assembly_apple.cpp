@@ -3,6 +3,8 @@
 #include <plugify/assembly.hpp>
 
 #include "os.h"
+#include "scan_cache.hpp"
+#include "vtable_index.hpp"
 	
 #if PLUGIFY_ARCH_BITS == 64
 	typedef struct mach_header_64 MachHeader;
@@ -113,7 +115,7 @@ bool Assembly::Init(fs::path modulePath, LoadFlag flags, const SearchDirs& /*add
 	return true;
 }
 
-MemAddr Assembly::GetVirtualTableByName(std::string_view tableName, bool /*decorated*/) const {
+MemAddr Assembly::FindVirtualTable(std::string_view tableName, bool /*decorated*/) const {
 	if (tableName.empty())
 		return nullptr;
 
@@ -3,6 +3,8 @@
 #include <plugify/assembly.hpp>
 
 #include "os.h"
+#include "scan_cache.hpp"
+#include "vtable_index.hpp"
 
 #if PLUGIFY_ARCH_BITS == 64
 	const unsigned char ELF_CLASS = ELFCLASS64;
@@ -14,6 +16,147 @@
 
 using namespace plugify;
 
+#if !PLUGIFY_PLATFORM_ANDROID
+namespace {
+	struct DynamicSymbols {
+		const ElfW(Sym)* symbols{};
+		const char* strings{};
+		const ElfW(Half)* versions{};
+		const uint32_t* gnuHash{};
+		const ElfW(Word)* sysvHash{};
+	};
+
+	DynamicSymbols GetDynamicSymbols(const link_map* map) noexcept {
+		// The dynamic section is relocated in place by glibc on most architectures, but not on all of them
+		const ElfW(Addr) base = map->l_addr;
+		auto relocate = [base](ElfW(Addr) ptr) {
+			return ptr < base ? ptr + base : ptr;
+		};
+
+		DynamicSymbols symbols;
+		for (const ElfW(Dyn)* dyn = map->l_ld; dyn->d_tag != DT_NULL; ++dyn) {
+			switch (dyn->d_tag) {
+				case DT_SYMTAB:
+					symbols.symbols = reinterpret_cast<const ElfW(Sym)*>(relocate(dyn->d_un.d_ptr));
+					break;
+				case DT_STRTAB:
+					symbols.strings = reinterpret_cast<const char*>(relocate(dyn->d_un.d_ptr));
+					break;
+				case DT_VERSYM:
+					symbols.versions = reinterpret_cast<const ElfW(Half)*>(relocate(dyn->d_un.d_ptr));
+					break;
+				case DT_GNU_HASH:
+					symbols.gnuHash = reinterpret_cast<const uint32_t*>(relocate(dyn->d_un.d_ptr));
+					break;
+				case DT_HASH:
+					symbols.sysvHash = reinterpret_cast<const ElfW(Word)*>(relocate(dyn->d_un.d_ptr));
+					break;
+				default:
+					break;
+			}
+		}
+		return symbols;
+	}
+
+	uint32_t GnuHash(std::string_view name) noexcept {
+		uint32_t hash = 5381;
+		for (char c : name) {
+			hash = (hash << 5) + hash + static_cast<uint8_t>(c);
+		}
+		return hash;
+	}
+
+	uint32_t SysvHash(std::string_view name) noexcept {
+		uint32_t hash = 0;
+		for (char c : name) {
+			hash = (hash << 4) + static_cast<uint8_t>(c);
+			uint32_t high = hash & 0xf0000000;
+			if (high)
+				hash ^= high >> 24;
+			hash &= ~high;
+		}
+		return hash;
+	}
+
+	bool IsMatch(const DynamicSymbols& symbols, uint32_t index, std::string_view name) noexcept {
+		const ElfW(Sym)& symbol = symbols.symbols[index];
+		if (symbol.st_shndx == SHN_UNDEF || symbol.st_value == 0)
+			return false;
+
+		// TLS and IFUNC symbols need the dynamic linker to compute their address, st_info is encoded the same way for both ELF classes
+		switch (ELF64_ST_TYPE(symbol.st_info)) {
+			case STT_NOTYPE:
+			case STT_OBJECT:
+			case STT_FUNC:
+				break;
+			default:
+				return false;
+		}
+
+		switch (ELF64_ST_BIND(symbol.st_info)) {
+			case STB_GLOBAL:
+			case STB_WEAK:
+			case STB_GNU_UNIQUE:
+				break;
+			default:
+				return false;
+		}
+
+		// Only the default version of a symbol is visible to dlsym
+		if (symbols.versions && (symbols.versions[index] & 0x8000))
+			return false;
+
+		const char* symbolName = symbols.strings + symbol.st_name;
+		return std::strncmp(symbolName, name.data(), name.size()) == 0 && symbolName[name.size()] == '\0';
+	}
+
+	const ElfW(Sym)* FindGnuSymbol(const DynamicSymbols& symbols, std::string_view name) noexcept {
+		const uint32_t* table = symbols.gnuHash;
+		const uint32_t bucketCount = table[0];
+		const uint32_t symbolOffset = table[1];
+		const uint32_t bloomSize = table[2];
+		const uint32_t bloomShift = table[3];
+		const ElfW(Addr)* bloom = reinterpret_cast<const ElfW(Addr)*>(table + 4);
+		const uint32_t* buckets = reinterpret_cast<const uint32_t*>(bloom + bloomSize);
+		const uint32_t* chain = buckets + bucketCount;
+
+		constexpr uint32_t kBloomBits = sizeof(ElfW(Addr)) * 8;
+		const uint32_t hash = GnuHash(name);
+
+		const ElfW(Addr) word = bloom[(hash / kBloomBits) & (bloomSize - 1)];
+		const ElfW(Addr) mask = (ElfW(Addr){1} << (hash % kBloomBits)) | (ElfW(Addr){1} << ((hash >> bloomShift) % kBloomBits));
+		if ((word & mask) != mask)
+			return nullptr;
+
+		uint32_t index = buckets[hash % bucketCount];
+		if (index < symbolOffset)
+			return nullptr;
+
+		for (;; ++index) {
+			const uint32_t chainHash = chain[index - symbolOffset];
+			if ((hash | 1) == (chainHash | 1) && IsMatch(symbols, index, name))
+				return &symbols.symbols[index];
+			// The lowest bit marks the end of the chain
+			if (chainHash & 1)
+				return nullptr;
+		}
+	}
+
+	const ElfW(Sym)* FindSysvSymbol(const DynamicSymbols& symbols, std::string_view name) noexcept {
+		const ElfW(Word)* table = symbols.sysvHash;
+		const ElfW(Word) bucketCount = table[0];
+		const ElfW(Word)* buckets = table + 2;
+		const ElfW(Word)* chain = buckets + bucketCount;
+
+		for (ElfW(Word) index = buckets[SysvHash(name) % bucketCount]; index != STN_UNDEF; index = chain[index]) {
+			if (IsMatch(symbols, index, name))
+				return &symbols.symbols[index];
+		}
+		return nullptr;
+	}
+}
+#endif // !PLUGIFY_PLATFORM_ANDROID
+
 Assembly::~Assembly() {
 	if (_handle) {
 		[[maybe_unused]] int error = dlclose(_handle);
@@ -92,111 +235,135 @@ bool Assembly::Init(fs::path modulePath, LoadFlag flags, const SearchDirs& /*add
 	_handle = handle;
 	_path = std::move(modulePath);
 
-	if (!sections)
-		return true;
+	// Section headers are only read when a section is looked up for the first time
+	_lazySections = sections;
+
+	return true;
+}
 
 #if !PLUGIFY_PLATFORM_ANDROID
+void Assembly::LoadSections() const {
+	if (!_lazySections || !_handle)
+		return;
+
+	// Failures are reported through GetError, the same way the eager read did before sections became lazy
+	auto setError = [this](const char* error) {
+		_error = error;
+#if PLUGIFY_LOGGING
+		PL_LOG_VERBOSE("Assembly::LoadSections() - '{}': {}", _path.c_str(), error);
+#endif // PLUGIFY_LOGGING
+	};
+
 	link_map* lmap;
-	if (dlinfo(handle, RTLD_DI_LINKMAP, &lmap) != 0) {
-		_error = "Failed to retrieve dynamic linker information using dlinfo.";
-		return false;
+	if (dlinfo(_handle, RTLD_DI_LINKMAP, &lmap) != 0) {
+		setError("Failed to retrieve dynamic linker information using dlinfo.");
+		return;
 	}
-/*
-	ElfW(Phdr) file = lmap->l_addr;
 
-	if (memcmp(ELFMAG, file->e_ident, SELFMAG) != 0) {
-		_error = "Not a valid ELF file.";
-		return false;
+	int fd = open(lmap->l_name, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		setError("Failed to open the shared object file.");
+		return;
 	}
 
-	if (file->e_ident[EI_VERSION] != EV_CURRENT) {
-		_error = "Not a valid ELF file version.";
-		return false;
-	}
+	// Only the ELF header, the section header table and the section name table are read, not the whole file
+	auto readAt = [fd](void* buffer, size_t size, uint64_t offset) {
+		auto* data = static_cast<uint8_t*>(buffer);
+		while (size > 0) {
+			ssize_t result = pread(fd, data, size, static_cast<off_t>(offset));
+			if (result <= 0)
+				return false;
+			data += result;
+			size -= static_cast<size_t>(result);
+			offset += static_cast<uint64_t>(result);
+		}
+		return true;
+	};
 
-	if (file->e_ident[EI_CLASS] != ELF_CLASS || file->e_machine != ELF_MACHINE || file->e_ident[EI_DATA] != ELFDATA2LSB) {
-		_error = "Not a valid ELF file architecture.";
-		return false;
-	}
+	auto readSections = [&]() -> const char* {
+		ElfW(Ehdr) ehdr;
+		if (!readAt(&ehdr, sizeof(ehdr), 0))
+			return "Failed to read the ELF header.";
 
-	if (file->e_type != ET_DYN) {
-		_error = "ELF file must be a dynamic library.";
-		return false;
-	}
-*/
-	int fd = open(lmap->l_name, O_RDONLY);
-	if (fd == -1) {
-		_error = "Failed to open the shared object file.";
-		return false;
-	}
+		if (std::memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 || ehdr.e_ident[EI_CLASS] != ELF_CLASS)
+			return "Not a valid ELF file.";
 
-	struct stat st{};
-	if (fstat(fd, &st) == 0) {
-		void* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
-		if (map != MAP_FAILED) {
-			ElfW(Ehdr)* ehdr = static_cast<ElfW(Ehdr)*>(map);
-			ElfW(Shdr)* shdrs = reinterpret_cast<ElfW(Shdr)*>(reinterpret_cast<uintptr_t>(ehdr) + ehdr->e_shoff);
-			const char* strTab = reinterpret_cast<const char*>(reinterpret_cast<uintptr_t>(ehdr) + shdrs[ehdr->e_shstrndx].sh_offset);
+		if (ehdr.e_shentsize != sizeof(ElfW(Shdr)) || ehdr.e_shnum == 0 || ehdr.e_shstrndx >= ehdr.e_shnum)
+			return "Not a valid ELF section header table.";
 
-			// Loop through the sections.
-			for (auto i = 0; i < ehdr->e_shnum; ++i) {
-				ElfW(Shdr)* shdr = reinterpret_cast<ElfW(Shdr)*>(reinterpret_cast<uintptr_t>(shdrs) + static_cast<uintptr_t>(i * ehdr->e_shentsize));
-				if (*(strTab + shdr->sh_name) == 0)
-					continue;
+		std::vector<ElfW(Shdr)> shdrs(ehdr.e_shnum);
+		if (!readAt(shdrs.data(), shdrs.size() * sizeof(ElfW(Shdr)), ehdr.e_shoff))
+			return "Failed to read the ELF section headers.";
 
-				_sections.emplace_back(strTab + shdr->sh_name, lmap->l_addr + shdr->sh_addr, shdr->sh_size);
-			}
+		const ElfW(Shdr)& strTabHeader = shdrs[ehdr.e_shstrndx];
+		std::string strTab(strTabHeader.sh_size, '\0');
+		if (!readAt(strTab.data(), strTab.size(), strTabHeader.sh_offset))
+			return "Failed to read the ELF section name table.";
+
+		_sections.reserve(shdrs.size());
 
-			munmap(map, static_cast<size_t>(st.st_size));
+		// Loop through the sections.
+		for (const auto& shdr : shdrs) {
+			if (shdr.sh_name >= strTab.size() || strTab[shdr.sh_name] == '\0')
+				continue;
+
+			_sections.emplace_back(strTab.c_str() + shdr.sh_name, lmap->l_addr + shdr.sh_addr, shdr.sh_size);
 		}
-	}
 
+		return nullptr;
+	};
+
+	const char* error = readSections();
 	close(fd);
 
-	_executableCode = GetSectionByName(".text");
-#endif // !PLUGIFY_PLATFORM_ANDROID
+	if (error) {
+		setError(error);
+		return;
+	}
 
-	return true;
+	auto it = std::find_if(_sections.begin(), _sections.end(), [](const Section& section) {
+		return section.name == ".text";
+	});
+	if (it != _sections.end()) {
+		_executableCode = *it;
+	}
 }
+#endif // !PLUGIFY_PLATFORM_ANDROID
 
-MemAddr Assembly::GetVirtualTableByName(std::string_view tableName, bool decorated) const {
-	if (tableName.empty())
-		return nullptr;
-
-	Assembly::Section readOnlyData = GetSectionByName(".rodata"), readOnlyRelocations = GetSectionByName(".data.rel.ro");
-	if (!readOnlyData.IsValid() || !readOnlyRelocations.IsValid())
-		return nullptr;
+const VirtualTableIndex* Assembly::GetVirtualTableIndex() const {
+	std::call_once(_virtualTableIndexFlag, [this] {
+		Assembly::Section readOnlyData = GetSectionByName(".rodata");
+		if (!readOnlyData.IsValid())
+			return;
+
+		std::vector<std::span<const uint8_t>> tables;
+		for (const auto& sectionName : {std::string_view(".data.rel.ro"), std::string_view(".data.rel.ro.local")}) {
+			Assembly::Section section = GetSectionByName(sectionName);
+			if (section.IsValid()) {
+				tables.emplace_back(section.base.RCast<const uint8_t*>(), section.size);
+			}
+		}
+		if (tables.empty())
+			return;
 
-	std::string decoratedTableName(decorated ? tableName : std::to_string(tableName.length()) + std::string(tableName));
-	std::string mask(decoratedTableName.length() + 1, 'x');
+		_virtualTableIndex = std::make_unique<VirtualTableIndex>(VirtualTableIndex::FromItanium(std::span(readOnlyData.base.RCast<const uint8_t*>(), readOnlyData.size), tables));
+	});
+	return _virtualTableIndex.get();
+}
 
-	MemAddr typeInfoName = FindPattern(decoratedTableName.data(), mask, nullptr, &readOnlyData);
-	if (!typeInfoName)
+MemAddr Assembly::FindVirtualTable(std::string_view tableName, bool decorated) const {
+	if (tableName.empty())
 		return nullptr;
 
-	MemAddr referenceTypeName = FindPattern(&typeInfoName, "xxxxxxxx", nullptr, &readOnlyRelocations);// Get reference to type name.
-	if (!referenceTypeName)
+	const VirtualTableIndex* index = GetVirtualTableIndex();
+	if (!index)
 		return nullptr;
 
-	MemAddr typeInfo = referenceTypeName.Offset(-0x8);// Offset -0x8 to typeinfo.
-
-	for (const auto& sectionName : {std::string_view(".data.rel.ro"), std::string_view(".data.rel.ro.local")}) {
-		Assembly::Section section = GetSectionByName(sectionName);
-		if (!section.IsValid())
-			continue;
-
-		MemAddr reference;// Get reference typeinfo in vtable
-		while ((reference = FindPattern(&typeInfo, "xxxxxxxx", reference, &section))) {
-			// Offset to this.
-			if (reference.Offset(-0x8).GetValue<int64_t>() == 0) {
-				return reference.Offset(0x8);
-			}
-
-			reference.OffsetSelf(0x8);
-		}
-	}
+	if (decorated)
+		return index->Find(tableName);
 
-	return nullptr;
+	std::string decoratedTableName(std::to_string(tableName.length()) + std::string(tableName));
+	return index->Find(decoratedTableName);
 }
 
 MemAddr Assembly::GetFunctionByName(std::string_view functionName) const noexcept {
@@ -215,10 +382,91 @@ MemAddr Assembly::GetFunctionByName(std::string_view functionName) const noexcep
 	return address;
 }
 
+#if !PLUGIFY_PLATFORM_ANDROID
+std::vector<MemAddr> Assembly::GetFunctionsByName(std::span<const std::string_view> functionNames) const {
+	std::vector<MemAddr> addresses(functionNames.size());
+	if (!_handle)
+		return addresses;
+
+	const link_map* map = static_cast<const link_map*>(_handle);
+	const DynamicSymbols symbols = GetDynamicSymbols(map);
+	const bool hasTables = symbols.symbols && symbols.strings && (symbols.gnuHash || symbols.sysvHash);
+
+	for (size_t i = 0; i < functionNames.size(); ++i) {
+		std::string_view functionName = functionNames[i];
+		if (functionName.empty())
+			continue;
+
+		const ElfW(Sym)* symbol = nullptr;
+		if (hasTables) {
+			symbol = symbols.gnuHash ? FindGnuSymbol(symbols, functionName) : FindSysvSymbol(symbols, functionName);
+		}
+
+		if (symbol) {
+			addresses[i] = static_cast<uintptr_t>(map->l_addr + symbol->st_value);
+		} else {
+			// Symbols from dependencies, or ones which need the dynamic linker
+			addresses[i] = GetFunctionByName(std::string(functionName));
+		}
+	}
+
+	return addresses;
+}
+#endif // !PLUGIFY_PLATFORM_ANDROID
+
 MemAddr Assembly::GetBase() const noexcept {
 	return static_cast<link_map*>(_handle)->l_addr;
 }
 
+std::string Assembly::GetBuildId() const {
+	if (!_handle)
+		return {};
+
+	struct Search {
+		const link_map* map;
+		std::string buildId;
+	} search{ static_cast<const link_map*>(_handle), {} };
+
+	// The notes are only reachable through the program headers, which link_map does not keep
+	dl_iterate_phdr([](dl_phdr_info* info, size_t, void* data) -> int {
+		auto& state = *static_cast<Search*>(data);
+		if (info->dlpi_addr != state.map->l_addr)
+			return 0;
+
+		for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+			const ElfW(Phdr)& header = info->dlpi_phdr[i];
+			if (header.p_type != PT_NOTE)
+				continue;
+
+			const size_t align = header.p_align == 8 ? 8 : 4;
+			auto alignUp = [align](size_t value) { return (value + align - 1) & ~(align - 1); };
+
+			const auto* notes = reinterpret_cast<const uint8_t*>(info->dlpi_addr + header.p_vaddr);
+			size_t offset = 0;
+			while (offset + sizeof(ElfW(Nhdr)) <= header.p_memsz) {
+				const auto* note = reinterpret_cast<const ElfW(Nhdr)*>(notes + offset);
+				const uint8_t* name = notes + offset + sizeof(ElfW(Nhdr));
+				const uint8_t* desc = name + alignUp(note->n_namesz);
+				offset += sizeof(ElfW(Nhdr)) + alignUp(note->n_namesz) + alignUp(note->n_descsz);
+				if (offset > header.p_memsz)
+					break;
+
+				if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && std::memcmp(name, "GNU", 4) == 0) {
+					constexpr char kDigits[] = "0123456789abcdef";
+					for (ElfW(Word) j = 0; j < note->n_descsz; ++j) {
+						state.buildId += kDigits[desc[j] >> 4];
+						state.buildId += kDigits[desc[j] & 0xF];
+					}
+					return 1;
+				}
+			}
+		}
+		return 0;
+	}, &search);
+
+	return search.buildId;
+}
+
 namespace plugify {
 	int TranslateLoading(LoadFlag flags) noexcept {
 		int unixFlags = 0;
@@ -3,6 +3,8 @@
 #include <plugify/assembly.hpp>
 
 #include "os.h"
+#include "scan_cache.hpp"
+#include "vtable_index.hpp"
 
 using namespace plugify;
 
@@ -101,7 +103,7 @@ bool Assembly::Init(fs::path modulePath, LoadFlag flags, const SearchDirs& /*add
 	return true;
 }
 
-MemAddr Assembly::GetVirtualTableByName(std::string_view tableName, bool /*decorated*/) const {
+MemAddr Assembly::FindVirtualTable(std::string_view tableName, bool /*decorated*/) const {
 	if (tableName.empty())
 		return nullptr;
 
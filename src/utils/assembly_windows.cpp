@@ -3,6 +3,8 @@
 #include <plugify/assembly.hpp>
 
 #include "os.h"
+#include "scan_cache.hpp"
+#include "vtable_index.hpp"
 #include "scope_guard.hpp"
 
 #if PLUGIFY_ARCH_BITS == 64
@@ -175,7 +177,7 @@ bool Assembly::Init(fs::path modulePath, LoadFlag flags, const SearchDirs& addit
 	return true;
 }
 
-MemAddr Assembly::GetVirtualTableByName(std::string_view tableName, bool decorated) const {
+MemAddr Assembly::FindVirtualTable(std::string_view tableName, bool decorated) const {
 	if (tableName.empty())
 		return nullptr;
 
@@ -186,25 +188,23 @@ MemAddr Assembly::GetVirtualTableByName(std::string_view tableName, bool decorat
 	std::string decoratedTableName(decorated ? tableName : ".?AV" + std::string(tableName) + "@@");
 	std::string mask(decoratedTableName.length() + 1, 'x');
 
-	MemAddr typeDescriptorName = FindPattern(decoratedTableName.data(), mask, nullptr, &runTimeData);
+	MemAddr typeDescriptorName = ScanPattern(decoratedTableName.data(), mask, nullptr, &runTimeData);
 	if (!typeDescriptorName)
 		return nullptr;
 
 	MemAddr rttiTypeDescriptor = typeDescriptorName.Offset(-0x10);
 	const uintptr_t rttiTDRva = rttiTypeDescriptor - GetBase();// The RTTI gets referenced by a 4-Byte RVA address. We need to scan for that address.
 
-	MemAddr reference; // Get reference typeinfo in vtable
-	while ((reference = FindPattern(&rttiTDRva, "xxxx", reference, &readOnlyData))) {
+	// Get reference typeinfo in vtable
+	for (MemAddr reference : FindAllPatterns(&rttiTDRva, "xxxx", nullptr, &readOnlyData)) {
 		// Check if we got a RTTI Object Locator for this reference by checking if -0xC is 1, which is the 'signature' field which is always 1 on x64.
 		// Check that offset of this vtable is 0
 		if (reference.Offset(-0xC).GetValue<int32_t>() == 1 && reference.Offset(-0x8).GetValue<int32_t>() == 0) {
 			MemAddr referenceOffset = reference.Offset(-0xC);
-			MemAddr rttiCompleteObjectLocator = FindPattern(&referenceOffset, "xxxxxxxx", nullptr, &readOnlyData);
+			MemAddr rttiCompleteObjectLocator = ScanPattern(&referenceOffset, "xxxxxxxx", nullptr, &readOnlyData);
 			if (rttiCompleteObjectLocator)
 				return rttiCompleteObjectLocator.Offset(0x8);
 		}
-
-		reference.OffsetSelf(0x4);
 	}
 
 	return nullptr;
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace plugify {
+	// Native byte order, the data never leaves the machine which wrote it
+	class BinaryWriter {
+	public:
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		void Write(const T& value) {
+			auto bytes = reinterpret_cast<const uint8_t*>(&value);
+			_buffer.insert(_buffer.end(), bytes, bytes + sizeof(T));
+		}
+
+		void Write(std::string_view str) {
+			Write(static_cast<uint32_t>(str.size()));
+			_buffer.insert(_buffer.end(), str.begin(), str.end());
+		}
+
+		void Write(const std::string& str) {
+			Write(std::string_view(str));
+		}
+
+		template<typename T>
+		void Write(const std::vector<T>& values) {
+			Write(static_cast<uint32_t>(values.size()));
+			for (const auto& value : values) {
+				Write(value);
+			}
+		}
+
+		template<typename T>
+		void Write(const std::optional<T>& value) {
+			Write(value.has_value());
+			if (value.has_value()) {
+				Write(*value);
+			}
+		}
+
+		std::span<const uint8_t> GetData() const noexcept {
+			return _buffer;
+		}
+
+	private:
+		std::vector<uint8_t> _buffer;
+	};
+
+	// Every read is bounds checked, after the first failure all following reads fail as well
+	class BinaryReader {
+	public:
+		explicit BinaryReader(std::span<const uint8_t> data) noexcept : _data{data} {}
+
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		bool Read(T& value) noexcept {
+			if (!Require(sizeof(T)))
+				return false;
+			std::memcpy(&value, _data.data() + _offset, sizeof(T));
+			_offset += sizeof(T);
+			return true;
+		}
+
+		bool Read(bool& value) noexcept {
+			uint8_t byte{};
+			if (!Read(byte))
+				return false;
+			if (byte > 1) {
+				_failed = true;
+				return false;
+			}
+			value = byte != 0;
+			return true;
+		}
+
+		bool Read(std::string& str) {
+			uint32_t size{};
+			if (!Read(size) || !Require(size))
+				return false;
+			str.assign(reinterpret_cast<const char*>(_data.data() + _offset), size);
+			_offset += size;
+			return true;
+		}
+
+		template<typename T>
+		bool Read(std::vector<T>& values) {
+			uint32_t size{};
+			// Every element takes at least one byte, so a corrupted size cannot trigger a huge allocation
+			if (!Read(size) || !Require(size))
+				return false;
+			values.clear();
+			values.reserve(size);
+			for (uint32_t i = 0; i < size; ++i) {
+				if (!Read(values.emplace_back()))
+					return false;
+			}
+			return true;
+		}
+
+		template<typename T>
+		bool Read(std::optional<T>& value) {
+			bool hasValue{};
+			if (!Read(hasValue))
+				return false;
+			if (!hasValue) {
+				value.reset();
+				return true;
+			}
+			return Read(value.emplace());
+		}
+
+		bool IsFailed() const noexcept {
+			return _failed;
+		}
+
+		bool IsEnd() const noexcept {
+			return _offset == _data.size();
+		}
+
+	private:
+		bool Require(size_t size) noexcept {
+			if (_failed || _data.size() - _offset < size) {
+				_failed = true;
+				return false;
+			}
+			return true;
+		}
+
+	private:
+		std::span<const uint8_t> _data;
+		size_t _offset{};
+		bool _failed{};
+	};
+}
@@ -0,0 +1,83 @@
+#include "graph.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+using namespace plugify;
+
+std::vector<Graph::Component> Graph::GetStronglyConnectedComponents() const {
+	constexpr Node kUnvisited = std::numeric_limits<Node>::max();
+
+	const size_t nodeCount = _edges.size();
+	std::vector<Node> index(nodeCount, kUnvisited);
+	std::vector<Node> lowLink(nodeCount, 0);
+	std::vector<bool> onStack(nodeCount, false);
+	std::vector<Node> stack;
+	std::vector<std::pair<Node, size_t>> callStack; /* [node, next edge] */
+	std::vector<Component> components;
+	Node nextIndex = 0;
+
+	auto visit = [&](Node node) {
+		index[node] = nextIndex;
+		lowLink[node] = nextIndex;
+		++nextIndex;
+		stack.push_back(node);
+		onStack[node] = true;
+		callStack.emplace_back(node, 0);
+	};
+
+	for (Node root = 0; root < nodeCount; ++root) {
+		if (index[root] != kUnvisited)
+			continue;
+
+		visit(root);
+
+		while (!callStack.empty()) {
+			const Node node = callStack.back().first;
+			size_t& edge = callStack.back().second;
+
+			const auto& edges = _edges[node];
+			if (edge < edges.size()) {
+				const Node next = edges[edge++];
+				if (index[next] == kUnvisited) {
+					visit(next);
+				} else if (onStack[next]) {
+					lowLink[node] = std::min(lowLink[node], index[next]);
+				}
+				continue;
+			}
+
+			callStack.pop_back();
+			if (!callStack.empty()) {
+				const Node parent = callStack.back().first;
+				lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+			}
+
+			if (lowLink[node] == index[node]) {
+				Component component;
+				Node member;
+				do {
+					member = stack.back();
+					stack.pop_back();
+					onStack[member] = false;
+					component.push_back(member);
+				} while (member != node);
+				std::sort(component.begin(), component.end());
+				components.emplace_back(std::move(component));
+			}
+		}
+	}
+
+	return components;
+}
+
+bool Graph::IsCyclic(const Component& component) const {
+	if (component.size() > 1)
+		return true;
+	if (component.empty())
+		return false;
+	const Node node = component.front();
+	const auto& edges = _edges[node];
+	return std::find(edges.begin(), edges.end(), node) != edges.end();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace plugify {
+	class Graph {
+	public:
+		using Node = size_t;
+		using Component = std::vector<Node>;
+
+		explicit Graph(size_t nodeCount) : _edges(nodeCount) {}
+
+		size_t GetNodeCount() const noexcept {
+			return _edges.size();
+		}
+
+		const std::vector<Node>& GetEdges(Node node) const noexcept {
+			return _edges[node];
+		}
+
+		void AddEdge(Node from, Node to) {
+			_edges[from].push_back(to);
+		}
+
+		// Tarjan's algorithm without recursion, O(V+E). A component is emitted only after every
+		// component reachable from it, so with edges pointing to dependencies the result is a load order.
+		std::vector<Component> GetStronglyConnectedComponents() const;
+
+		// True if the component has more than one node or a node with an edge to itself
+		bool IsCyclic(const Component& component) const;
+
+	private:
+		std::vector<std::vector<Node>> _edges;
+	};
+}
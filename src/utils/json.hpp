@@ -8,6 +8,7 @@
 #include <plugify/config.hpp>
 #include <plugify/descriptor.hpp>
 #include <plugify/package.hpp>
+#include <utils/trace.hpp>
 
 template<>
 struct glz::meta<plugify::ValueType> {
@@ -83,7 +84,8 @@ struct glz::meta<plugify::PluginDescriptor> {
 			"entryPoint", &T::entryPoint,
 			"languageModule", &T::languageModule,
 			"dependencies", &T::dependencies,
-			"exportedMethods", &T::exportedMethods
+			"exportedMethods", &T::exportedMethods,
+			"lazy", &T::lazy
 	);
 };
 
@@ -105,7 +107,9 @@ struct glz::meta<plugify::LanguageModuleDescriptor> {
 			"resourceDirectories", &T::resourceDirectories,
 			"language", &T::language,
 			"libraryDirectories", &T::libraryDirectories,
-			"forceLoad", &T::forceLoad
+			"forceLoad", &T::forceLoad,
+			"threadSafe", &T::threadSafe,
+			"batchMethodExport", &T::batchMethodExport
 	);
 };
 
@@ -127,7 +131,12 @@ struct glz::meta<plugify::Config> {
 			"baseDir", &T::baseDir,
 			"logSeverity", &T::logSeverity,
 			"repositories", &T::repositories,
-			"preferOwnSymbols", &T::preferOwnSymbols
+			"preferOwnSymbols", &T::preferOwnSymbols,
+			"parallelLoad", &T::parallelLoad,
+			"packageCache", &T::packageCache,
+			"prefetchBinaries", &T::prefetchBinaries,
+			"measurePageFaults", &T::measurePageFaults,
+			"traceFile", &T::traceFile
 	);
 };
 
@@ -213,3 +222,27 @@ namespace glz::detail {
 		}
 	};
 }
+
+template <>
+struct glz::meta<plugify::TraceEvent> {
+	using T = plugify::TraceEvent;
+	static constexpr auto value = object(
+			"name", &T::name,
+			"cat", &T::cat,
+			"ph", &T::ph,
+			"ts", &T::ts,
+			"dur", &T::dur,
+			"pid", &T::pid,
+			"tid", &T::tid,
+			"args", &T::args
+	);
+};
+
+template <>
+struct glz::meta<plugify::TraceFile> {
+	using T = plugify::TraceFile;
+	static constexpr auto value = object(
+			"traceEvents", &T::traceEvents,
+			"displayTimeUnit", &T::displayTimeUnit
+	);
+};
@@ -0,0 +1,576 @@
+#include "pattern_scanner.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+#if !PLUGIFY_ARCH_ARM
+#include <immintrin.h>
+#if PLUGIFY_COMPILER_MSVC
+#include <intrin.h>
+#define PLUGIFY_TARGET(features)
+#else
+#define PLUGIFY_TARGET(features) __attribute__((target(features)))
+#endif // PLUGIFY_COMPILER_MSVC
+#endif // !PLUGIFY_ARCH_ARM
+
+using namespace plugify;
+
+namespace {
+	// Rough frequency rank of bytes in x86-64 machine code, higher is more common. Unlisted bytes count as rare.
+	constexpr std::array<uint8_t, 256> kByteFrequency = [] {
+		constexpr uint8_t kCommonBytes[] = {
+			0x00, 0xFF, 0x48, 0x8B, 0x89, 0x24, 0x0F, 0x44, 0x4C, 0x85, 0xE8, 0x01, 0x83, 0xC0, 0x74, 0x75,
+			0x45, 0x8D, 0x10, 0x08, 0x20, 0x41, 0x49, 0xCC, 0xC3, 0x90, 0x5D, 0x55, 0x53, 0x5B, 0x50, 0x40,
+			0x18, 0xE9, 0xEB, 0x84, 0x31, 0x39, 0x3B, 0x28, 0x30, 0x38, 0x02, 0x04, 0x03, 0x80, 0xC7, 0x66,
+			0xF3, 0xC1, 0x0C, 0x4D, 0x54, 0x5C, 0x63, 0x70, 0x78, 0x7C, 0xC6, 0xE0, 0xF0, 0xF8,
+		};
+		std::array<uint8_t, 256> frequency{};
+		uint8_t rank = static_cast<uint8_t>(std::size(kCommonBytes));
+		for (uint8_t byte : kCommonBytes) {
+			frequency[byte] = rank--;
+		}
+		return frequency;
+	}();
+
+#if !PLUGIFY_ARCH_ARM
+	struct CpuFeatures {
+		bool avx2{};
+		bool avx512bw{};
+	};
+
+	CpuFeatures DetectCpuFeatures() noexcept {
+		CpuFeatures features;
+#if PLUGIFY_COMPILER_MSVC
+		int regs[4];
+		__cpuid(regs, 0);
+		if (regs[0] < 7)
+			return features;
+
+		__cpuid(regs, 1);
+		// The OS has to save the extended registers on context switches
+		bool osxsave = (regs[2] & (1 << 27)) != 0;
+		if (!osxsave)
+			return features;
+		uint64_t xcr0 = _xgetbv(0);
+		bool ymm = (xcr0 & 0x6) == 0x6;
+		bool zmm = (xcr0 & 0xE6) == 0xE6;
+
+		__cpuidex(regs, 7, 0);
+		features.avx2 = ymm && (regs[1] & (1 << 5)) != 0;
+		features.avx512bw = zmm && (regs[1] & (1 << 16)) != 0 && (regs[1] & (1 << 30)) != 0;
+#else
+		// Also checks that the OS saves the extended registers
+		__builtin_cpu_init();
+		features.avx2 = __builtin_cpu_supports("avx2");
+		features.avx512bw = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif // PLUGIFY_COMPILER_MSVC
+		return features;
+	}
+
+	const CpuFeatures& GetCpuFeatures() noexcept {
+		static const CpuFeatures features = DetectCpuFeatures();
+		return features;
+	}
+#endif // !PLUGIFY_ARCH_ARM
+}
+
+Pattern::Pattern(std::span<const uint8_t> bytes, std::string_view mask) : _bytes(bytes.begin(), bytes.begin() + static_cast<ptrdiff_t>(std::min(bytes.size(), mask.size()))) {
+	_mask.resize(_bytes.size());
+	for (size_t i = 0; i < _bytes.size(); ++i) {
+		_mask[i] = mask[i] == 'x' ? 0xFF : 0x00;
+	}
+
+	// The rarest fixed byte filters best, the second anchor has to be at another offset to add information
+	auto rarer = [this](size_t lhs, size_t rhs) {
+		return kByteFrequency[_bytes[lhs]] < kByteFrequency[_bytes[rhs]];
+	};
+
+	for (size_t i = 0; i < _bytes.size(); ++i) {
+		if (!_mask[i])
+			continue;
+		if (!_hasAnchor) {
+			_firstAnchor = _secondAnchor = i;
+			_hasAnchor = true;
+		} else if (rarer(i, _firstAnchor)) {
+			_secondAnchor = _firstAnchor;
+			_firstAnchor = i;
+		} else if (_secondAnchor == _firstAnchor || rarer(i, _secondAnchor)) {
+			_secondAnchor = i;
+		}
+	}
+}
+
+bool Pattern::IsMatch(const uint8_t* data) const noexcept {
+	for (size_t i = 0; i < _bytes.size(); ++i) {
+		if ((data[i] ^ _bytes[i]) & _mask[i])
+			return false;
+	}
+	return true;
+}
+
+namespace {
+	struct ScanContext {
+		const Pattern& pattern;
+		const uint8_t* first;  // first candidate position
+		size_t count;          // number of candidate positions
+		size_t firstAnchor;
+		size_t secondAnchor;
+		uint8_t firstByte;
+		uint8_t secondByte;
+	};
+
+	const uint8_t* ScanScalar(const ScanContext& ctx, size_t offset) noexcept {
+		const uint8_t* data = ctx.first;
+		while (offset < ctx.count) {
+			const void* found = std::memchr(data + offset + ctx.firstAnchor, ctx.firstByte, ctx.count - offset);
+			if (!found)
+				return nullptr;
+			size_t position = static_cast<size_t>(static_cast<const uint8_t*>(found) - data) - ctx.firstAnchor;
+			if (data[position + ctx.secondAnchor] == ctx.secondByte && ctx.pattern.IsMatch(data + position))
+				return data + position;
+			offset = position + 1;
+		}
+		return nullptr;
+	}
+
+#if !PLUGIFY_ARCH_ARM
+	// Verifies the candidate positions of a block, lowest first
+	template<typename Mask>
+	const uint8_t* VerifyCandidates(const ScanContext& ctx, size_t offset, Mask bits) noexcept {
+		while (bits) {
+			const uint8_t* candidate = ctx.first + offset + static_cast<size_t>(std::countr_zero(bits));
+			if (ctx.pattern.IsMatch(candidate))
+				return candidate;
+			bits &= bits - 1;
+		}
+		return nullptr;
+	}
+
+	// The main loops test four blocks against the first anchor only, which is enough to skip most of the data.
+	// Blocks with a hit are then filtered by the second anchor and verified.
+
+	const uint8_t* ScanSSE2(const ScanContext& ctx) noexcept {
+		const __m128i first = _mm_set1_epi8(static_cast<char>(ctx.firstByte));
+		const __m128i second = _mm_set1_epi8(static_cast<char>(ctx.secondByte));
+
+		auto load = [&](size_t offset, size_t anchor) {
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctx.first + offset + anchor));
+		};
+		auto scanBlock = [&](size_t offset, __m128i hits) {
+			hits = _mm_and_si128(hits, _mm_cmpeq_epi8(second, load(offset, ctx.secondAnchor)));
+			return VerifyCandidates(ctx, offset, static_cast<uint32_t>(_mm_movemask_epi8(hits)));
+		};
+
+		size_t offset = 0;
+		for (; offset + 64 <= ctx.count; offset += 64) {
+			__m128i h0 = _mm_cmpeq_epi8(first, load(offset, ctx.firstAnchor));
+			__m128i h1 = _mm_cmpeq_epi8(first, load(offset + 16, ctx.firstAnchor));
+			__m128i h2 = _mm_cmpeq_epi8(first, load(offset + 32, ctx.firstAnchor));
+			__m128i h3 = _mm_cmpeq_epi8(first, load(offset + 48, ctx.firstAnchor));
+			if (!_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(h0, h1), _mm_or_si128(h2, h3))))
+				continue;
+			if (const uint8_t* found = scanBlock(offset, h0))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 16, h1))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 32, h2))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 48, h3))
+				return found;
+		}
+		for (; offset + 16 <= ctx.count; offset += 16) {
+			if (const uint8_t* found = scanBlock(offset, _mm_cmpeq_epi8(first, load(offset, ctx.firstAnchor))))
+				return found;
+		}
+		return ScanScalar(ctx, offset);
+	}
+
+	PLUGIFY_TARGET("avx2")
+	const uint8_t* ScanAVX2(const ScanContext& ctx) noexcept {
+		const __m256i first = _mm256_set1_epi8(static_cast<char>(ctx.firstByte));
+		const __m256i second = _mm256_set1_epi8(static_cast<char>(ctx.secondByte));
+
+		auto load = [&](size_t offset, size_t anchor) PLUGIFY_TARGET("avx2") {
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ctx.first + offset + anchor));
+		};
+		auto scanBlock = [&](size_t offset, __m256i hits) PLUGIFY_TARGET("avx2") {
+			hits = _mm256_and_si256(hits, _mm256_cmpeq_epi8(second, load(offset, ctx.secondAnchor)));
+			return VerifyCandidates(ctx, offset, static_cast<uint32_t>(_mm256_movemask_epi8(hits)));
+		};
+
+		size_t offset = 0;
+		for (; offset + 128 <= ctx.count; offset += 128) {
+			__m256i h0 = _mm256_cmpeq_epi8(first, load(offset, ctx.firstAnchor));
+			__m256i h1 = _mm256_cmpeq_epi8(first, load(offset + 32, ctx.firstAnchor));
+			__m256i h2 = _mm256_cmpeq_epi8(first, load(offset + 64, ctx.firstAnchor));
+			__m256i h3 = _mm256_cmpeq_epi8(first, load(offset + 96, ctx.firstAnchor));
+			__m256i any = _mm256_or_si256(_mm256_or_si256(h0, h1), _mm256_or_si256(h2, h3));
+			if (_mm256_testz_si256(any, any))
+				continue;
+			if (const uint8_t* found = scanBlock(offset, h0))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 32, h1))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 64, h2))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 96, h3))
+				return found;
+		}
+		for (; offset + 32 <= ctx.count; offset += 32) {
+			if (const uint8_t* found = scanBlock(offset, _mm256_cmpeq_epi8(first, load(offset, ctx.firstAnchor))))
+				return found;
+		}
+		return ScanScalar(ctx, offset);
+	}
+
+	PLUGIFY_TARGET("avx512f,avx512bw")
+	const uint8_t* ScanAVX512(const ScanContext& ctx) noexcept {
+		const __m512i first = _mm512_set1_epi8(static_cast<char>(ctx.firstByte));
+		const __m512i second = _mm512_set1_epi8(static_cast<char>(ctx.secondByte));
+
+		auto load = [&](size_t offset, size_t anchor) PLUGIFY_TARGET("avx512f,avx512bw") {
+			return _mm512_loadu_si512(ctx.first + offset + anchor);
+		};
+		auto scanBlock = [&](size_t offset, __mmask64 hits) PLUGIFY_TARGET("avx512f,avx512bw") {
+			hits &= _mm512_cmpeq_epi8_mask(second, load(offset, ctx.secondAnchor));
+			return VerifyCandidates(ctx, offset, static_cast<uint64_t>(hits));
+		};
+
+		size_t offset = 0;
+		for (; offset + 256 <= ctx.count; offset += 256) {
+			__mmask64 h0 = _mm512_cmpeq_epi8_mask(first, load(offset, ctx.firstAnchor));
+			__mmask64 h1 = _mm512_cmpeq_epi8_mask(first, load(offset + 64, ctx.firstAnchor));
+			__mmask64 h2 = _mm512_cmpeq_epi8_mask(first, load(offset + 128, ctx.firstAnchor));
+			__mmask64 h3 = _mm512_cmpeq_epi8_mask(first, load(offset + 192, ctx.firstAnchor));
+			if (!(h0 | h1 | h2 | h3))
+				continue;
+			if (const uint8_t* found = scanBlock(offset, h0))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 64, h1))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 128, h2))
+				return found;
+			if (const uint8_t* found = scanBlock(offset + 192, h3))
+				return found;
+		}
+		for (; offset + 64 <= ctx.count; offset += 64) {
+			if (const uint8_t* found = scanBlock(offset, _mm512_cmpeq_epi8_mask(first, load(offset, ctx.firstAnchor))))
+				return found;
+		}
+		return ScanScalar(ctx, offset);
+	}
+#endif // !PLUGIFY_ARCH_ARM
+}
+
+const uint8_t* Pattern::Find(const uint8_t* begin, const uint8_t* end) const noexcept {
+	return Find(begin, end, GetBestKernel());
+}
+
+const uint8_t* Pattern::Find(const uint8_t* begin, const uint8_t* end, ScanKernel kernel) const noexcept {
+	if (!begin || end < begin || static_cast<size_t>(end - begin) < _bytes.size())
+		return nullptr;
+
+	// Loads never go past 'end': the last block starts at most at the last candidate position
+	const size_t count = static_cast<size_t>(end - begin) - _bytes.size() + 1;
+	if (!_hasAnchor)
+		return begin;
+
+	const ScanContext ctx{ *this, begin, count, _firstAnchor, _secondAnchor, _bytes[_firstAnchor], _bytes[_secondAnchor] };
+
+	if (!IsSupported(kernel)) {
+		kernel = GetBestKernel();
+	}
+
+	switch (kernel) {
+#if !PLUGIFY_ARCH_ARM
+		case ScanKernel::AVX512:
+			return ScanAVX512(ctx);
+		case ScanKernel::AVX2:
+			return ScanAVX2(ctx);
+		case ScanKernel::SSE2:
+			return ScanSSE2(ctx);
+#endif // !PLUGIFY_ARCH_ARM
+		default:
+			return ScanScalar(ctx, 0);
+	}
+}
+
+size_t Pattern::Count(const uint8_t* begin, const uint8_t* end, size_t limit) const noexcept {
+	const ScanKernel kernel = GetBestKernel();
+	size_t count = 0;
+	for (const uint8_t* found = begin; count < limit && (found = Find(found, end, kernel)); ++found) {
+		++count;
+	}
+	return count;
+}
+
+const uint8_t* Pattern::FindParallel(const uint8_t* begin, const uint8_t* end, size_t threadCount, size_t chunkSize) const {
+	if (!begin || end < begin || static_cast<size_t>(end - begin) < _bytes.size())
+		return nullptr;
+
+	// Every candidate position belongs to exactly one chunk, the data of a chunk reaches 'size - 1' bytes into the next
+	const size_t count = static_cast<size_t>(end - begin) - _bytes.size() + 1;
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	threadCount = std::min(threadCount, chunkCount);
+	if (threadCount <= 1)
+		return Find(begin, end);
+
+	const ScanKernel kernel = GetBestKernel();
+	std::vector<const uint8_t*> found(chunkCount, nullptr);
+	std::atomic<size_t> nextChunk{ 0 };
+	std::atomic<size_t> firstHit{ chunkCount };
+
+	auto worker = [&] {
+		while (true) {
+			const size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+			// A match in an earlier chunk wins, so later chunks do not have to be scanned at all
+			if (chunk >= firstHit.load(std::memory_order_relaxed))
+				return;
+
+			const uint8_t* chunkBegin = begin + chunk * chunkSize;
+			const size_t candidates = std::min(chunkSize, count - chunk * chunkSize);
+			found[chunk] = Find(chunkBegin, chunkBegin + candidates + _bytes.size() - 1, kernel);
+			if (found[chunk]) {
+				size_t current = firstHit.load(std::memory_order_relaxed);
+				while (chunk < current && !firstHit.compare_exchange_weak(current, chunk, std::memory_order_relaxed)) {
+				}
+				return;
+			}
+		}
+	};
+
+	{
+		ThreadPool pool(threadCount - 1);
+		for (size_t i = 1; i < threadCount; ++i) {
+			pool.Submit(worker);
+		}
+		worker();
+		pool.Wait();
+	}
+
+	const size_t hit = firstHit.load();
+	return hit < chunkCount ? found[hit] : nullptr;
+}
+
+ScanKernel Pattern::GetBestKernel() noexcept {
+#if !PLUGIFY_ARCH_ARM
+	const auto& features = GetCpuFeatures();
+	if (features.avx512bw)
+		return ScanKernel::AVX512;
+	if (features.avx2)
+		return ScanKernel::AVX2;
+	return ScanKernel::SSE2;
+#else
+	return ScanKernel::Scalar;
+#endif // !PLUGIFY_ARCH_ARM
+}
+
+bool Pattern::IsSupported(ScanKernel kernel) noexcept {
+	switch (kernel) {
+		case ScanKernel::Scalar:
+			return true;
+#if !PLUGIFY_ARCH_ARM
+		case ScanKernel::SSE2:
+			return true;
+		case ScanKernel::AVX2:
+			return GetCpuFeatures().avx2;
+		case ScanKernel::AVX512:
+			return GetCpuFeatures().avx512bw;
+#endif // !PLUGIFY_ARCH_ARM
+		default:
+			return false;
+	}
+}
+
+namespace {
+	constexpr uint32_t kFibonacci = 0x9E3779B1u;
+
+	// The run of 'width' adjacent fixed bytes which is least common in code, or the pattern size if there is none
+	size_t FindRarestRun(std::span<const uint8_t> bytes, std::span<const uint8_t> mask, size_t width) {
+		size_t best = bytes.size();
+		int bestScore = 0;
+		size_t run = 0;
+		for (size_t i = 0; i < bytes.size(); ++i) {
+			run = mask[i] ? run + 1 : 0;
+			if (run < width)
+				continue;
+			size_t start = i + 1 - width;
+			int score = 0;
+			for (size_t j = start; j <= i; ++j) {
+				score += kByteFrequency[bytes[j]];
+			}
+			if (best == bytes.size() || score < bestScore) {
+				best = start;
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+
+	uint32_t LoadKey(const uint8_t* data, size_t width) noexcept {
+		uint32_t key = 0;
+		std::memcpy(&key, data, width);
+		return key;
+	}
+}
+
+void PatternSet::KeyTable::Add(uint32_t key, uint32_t index, uint32_t anchor) {
+	entries.push_back({ key, index, anchor });
+	uint32_t slot = GetSlot(key);
+	filter[slot >> 6] |= uint64_t{1} << (slot & 63);
+}
+
+uint32_t PatternSet::KeyTable::GetSlot(uint32_t key) const noexcept {
+	// Fibonacci hashing, the high bits of the product depend on every byte of the key
+	return (key * kFibonacci) >> (32 - filterBits);
+}
+
+bool PatternSet::KeyTable::MayContain(uint32_t key) const noexcept {
+	uint32_t slot = GetSlot(key);
+	return (filter[slot >> 6] >> (slot & 63)) & 1;
+}
+
+PatternSet::PatternSet(std::vector<Pattern> patterns) : _patterns(std::move(patterns)) {
+	// 64 Kbit filters stay in the L1 cache and still keep several hundred keys apart
+	_quads.filterBits = 16;
+	_pairs.filterBits = 16;
+	_singles.filterBits = 8;
+	for (KeyTable* table : { &_quads, &_pairs, &_singles }) {
+		table->filter.resize((size_t{1} << table->filterBits) / 64);
+	}
+
+	for (size_t i = 0; i < _patterns.size(); ++i) {
+		const Pattern& pattern = _patterns[i];
+		const auto index = static_cast<uint32_t>(i);
+
+		bool keyed = false;
+		for (auto [table, width] : { std::pair{ &_quads, size_t{4} }, std::pair{ &_pairs, size_t{2} }, std::pair{ &_singles, size_t{1} } }) {
+			size_t anchor = FindRarestRun(pattern._bytes, pattern._mask, width);
+			if (anchor == pattern._bytes.size())
+				continue;
+			table->Add(LoadKey(pattern._bytes.data() + anchor, width), index, static_cast<uint32_t>(anchor));
+			keyed = true;
+			break;
+		}
+		if (!keyed) {
+			_unanchored.push_back(index);
+		}
+	}
+
+	// Stable, so patterns sharing a key are still visited in index order
+	for (KeyTable* table : { &_quads, &_pairs, &_singles }) {
+		std::stable_sort(table->entries.begin(), table->entries.end(), [](const Entry& lhs, const Entry& rhs) {
+			return lhs.key < rhs.key;
+		});
+	}
+}
+
+// Calls 'callback(index, address)' for every match, in order of the key position. Matches of one pattern are
+// reported in increasing address order. Patterns for which 'skip(index)' is true are not verified any more.
+// Stops as soon as the callback returns false.
+template<typename Skip, typename Callback>
+void PatternSet::Scan(const uint8_t* begin, const uint8_t* end, Skip&& skip, Callback&& callback) const {
+	if (!begin || end <= begin)
+		return;
+
+	const size_t size = static_cast<size_t>(end - begin);
+
+	auto visit = [&](const KeyTable& table, uint32_t key, size_t position) {
+		auto it = std::lower_bound(table.entries.begin(), table.entries.end(), key, [](const Entry& entry, uint32_t value) {
+			return entry.key < value;
+		});
+		for (; it != table.entries.end() && it->key == key; ++it) {
+			if (position < it->anchor || skip(it->index))
+				continue;
+			size_t start = position - it->anchor;
+			const Pattern& pattern = _patterns[it->index];
+			if (size - start < pattern.GetSize() || !pattern.IsMatch(begin + start))
+				continue;
+			if (!callback(static_cast<size_t>(it->index), begin + start))
+				return false;
+		}
+		return true;
+	};
+
+	const bool hasPairs = !_pairs.entries.empty();
+	const bool hasSingles = !_singles.entries.empty();
+
+	auto visitNarrow = [&](size_t position) {
+		if (hasPairs && size - position >= 2) {
+			uint32_t key = LoadKey(begin + position, 2);
+			if (_pairs.MayContain(key) && !visit(_pairs, key, position))
+				return false;
+		}
+		if (hasSingles) {
+			uint32_t key = begin[position];
+			if (_singles.MayContain(key) && !visit(_singles, key, position))
+				return false;
+		}
+		return true;
+	};
+
+	for (uint32_t index : _unanchored) {
+		const size_t patternSize = _patterns[index].GetSize();
+		for (size_t start = 0; patternSize <= size - start && !skip(index); ++start) {
+			if (!callback(static_cast<size_t>(index), begin + start))
+				return;
+		}
+	}
+
+	// Four byte keys go first, the narrower tiers only have to be checked when they hold any patterns
+	size_t position = 0;
+	if (!_quads.entries.empty() && size >= 4) {
+		const uint64_t* filter = _quads.filter.data();
+		const uint32_t shift = 32 - _quads.filterBits;
+		for (; position + 4 <= size; ++position) {
+			uint32_t key = LoadKey(begin + position, 4);
+			uint32_t slot = (key * kFibonacci) >> shift;
+			if ((filter[slot >> 6] >> (slot & 63)) & 1) [[unlikely]] {
+				if (!visit(_quads, key, position))
+					return;
+			}
+			if (hasPairs || hasSingles) {
+				if (!visitNarrow(position))
+					return;
+			}
+		}
+	}
+	for (; position < size; ++position) {
+		if (!visitNarrow(position))
+			return;
+	}
+}
+
+std::vector<PatternSet::Match> PatternSet::FindAll(const uint8_t* begin, const uint8_t* end) const {
+	std::vector<Match> matches;
+	Scan(begin, end, [](size_t) { return false; }, [&](size_t index, const uint8_t* address) {
+		matches.push_back({ index, address });
+		return true;
+	});
+
+	std::sort(matches.begin(), matches.end(), [](const Match& lhs, const Match& rhs) {
+		return lhs.address != rhs.address ? lhs.address < rhs.address : lhs.index < rhs.index;
+	});
+	return matches;
+}
+
+std::vector<const uint8_t*> PatternSet::FindFirst(const uint8_t* begin, const uint8_t* end) const {
+	std::vector<const uint8_t*> found(_patterns.size(), nullptr);
+	size_t remaining = _patterns.size();
+	if (remaining == 0)
+		return found;
+
+	Scan(begin, end, [&](size_t index) { return found[index] != nullptr; }, [&](size_t index, const uint8_t* address) {
+		if (!found[index]) {
+			found[index] = address;
+			--remaining;
+		}
+		return remaining != 0;
+	});
+	return found;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace plugify {
+	enum class ScanKernel : uint8_t {
+		Scalar,
+		SSE2,
+		AVX2,
+		AVX512,
+	};
+
+	// Byte pattern with wildcards, prepared for scanning.
+	// Two rare fixed bytes of the pattern are used as anchors: the vector kernels compare them at 16/32/64 positions
+	// at once and only the positions where both anchors match are verified against the whole pattern.
+	class Pattern {
+	public:
+		// Bytes with 'x' in the mask must match, any other mask character is a wildcard
+		Pattern(std::span<const uint8_t> bytes, std::string_view mask);
+
+		// Returns the first position in [begin, end) where the whole pattern fits and matches, or nullptr
+		const uint8_t* Find(const uint8_t* begin, const uint8_t* end) const noexcept;
+		const uint8_t* Find(const uint8_t* begin, const uint8_t* end, ScanKernel kernel) const noexcept;
+
+		// Same result as Find, the range is split into chunks which are scanned on up to 'threadCount' threads.
+		// Chunks are taken in address order and the ones after a chunk with a match are skipped.
+		const uint8_t* FindParallel(const uint8_t* begin, const uint8_t* end, size_t threadCount, size_t chunkSize = kParallelChunkSize) const;
+
+		// Number of matches in [begin, end), matches may overlap. Stops counting at 'limit'.
+		size_t Count(const uint8_t* begin, const uint8_t* end, size_t limit = SIZE_MAX) const noexcept;
+
+		bool IsMatch(const uint8_t* data) const noexcept;
+
+		size_t GetSize() const noexcept {
+			return _bytes.size();
+		}
+
+		// The best kernel supported by the CPU, detected once
+		static ScanKernel GetBestKernel() noexcept;
+		static bool IsSupported(ScanKernel kernel) noexcept;
+
+		// Candidate positions per chunk, big enough that the scan outweighs handing the chunk to a thread
+		static constexpr size_t kParallelChunkSize = 1 << 20;
+
+	private:
+		friend class PatternSet;
+
+		std::vector<uint8_t> _bytes;
+		std::vector<uint8_t> _mask;
+		size_t _firstAnchor{};
+		size_t _secondAnchor{};
+		bool _hasAnchor{};
+	};
+
+	// Several patterns matched in a single pass over the data.
+	// Every pattern is keyed by its rarest run of four adjacent fixed bytes, or failing that two adjacent bytes or
+	// a single byte. The scan tests each position against a bit filter of the keys and only looks up the candidate
+	// table on a filter hit.
+	class PatternSet {
+	public:
+		struct Match {
+			size_t index;            // index of the pattern in the set
+			const uint8_t* address;  // first byte of the match
+		};
+
+		explicit PatternSet(std::vector<Pattern> patterns);
+
+		// Returns every match of every pattern in [begin, end), ordered by address and then by pattern index
+		std::vector<Match> FindAll(const uint8_t* begin, const uint8_t* end) const;
+		// Returns the first match of every pattern in [begin, end), nullptr for patterns which are not found
+		std::vector<const uint8_t*> FindFirst(const uint8_t* begin, const uint8_t* end) const;
+
+		size_t GetCount() const noexcept {
+			return _patterns.size();
+		}
+
+	private:
+		struct Entry {
+			uint32_t key;
+			uint32_t index;
+			uint32_t anchor;  // offset of the key bytes in the pattern
+		};
+
+		// Keys of one width with the filter over them
+		struct KeyTable {
+			std::vector<Entry> entries;  // sorted by key
+			std::vector<uint64_t> filter;
+			uint32_t filterBits{};
+
+			void Add(uint32_t key, uint32_t index, uint32_t anchor);
+			uint32_t GetSlot(uint32_t key) const noexcept;
+			bool MayContain(uint32_t key) const noexcept;
+		};
+
+		template<typename Skip, typename Callback>
+		void Scan(const uint8_t* begin, const uint8_t* end, Skip&& skip, Callback&& callback) const;
+
+	private:
+		std::vector<Pattern> _patterns;
+		KeyTable _quads;
+		KeyTable _pairs;
+		KeyTable _singles;
+		std::vector<uint32_t> _unanchored;  // patterns without fixed bytes match everywhere
+	};
+}
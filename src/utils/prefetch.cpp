@@ -0,0 +1,63 @@
+#include "prefetch.hpp"
+#include "os.h"
+
+#if PLUGIFY_PLATFORM_LINUX || PLUGIFY_PLATFORM_APPLE
+#include <sys/resource.h>
+#endif
+
+#include <limits>
+
+using namespace plugify;
+
+bool Prefetcher::Prefetch(const fs::path& filePath) {
+#if PLUGIFY_PLATFORM_LINUX
+	int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return false;
+	// WILLNEED only queues the readahead, the page cache is filled in the background
+	bool result = posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED) == 0;
+	close(fd);
+	return result;
+#elif PLUGIFY_PLATFORM_APPLE
+	int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return false;
+	struct stat st{};
+	bool result = false;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		radvisory advisory{};
+		advisory.ra_offset = 0;
+		advisory.ra_count = static_cast<int>(std::min<off_t>(st.st_size, std::numeric_limits<int>::max()));
+		result = fcntl(fd, F_RDADVISE, &advisory) != -1;
+	}
+	close(fd);
+	return result;
+#else
+	(void) filePath;
+	return false;
+#endif
+}
+
+PageFaults PageFaults::Capture() noexcept {
+#if PLUGIFY_PLATFORM_LINUX || PLUGIFY_PLATFORM_APPLE
+#if PLUGIFY_PLATFORM_LINUX
+	constexpr int who = RUSAGE_THREAD;
+#else
+	constexpr int who = RUSAGE_SELF;
+#endif
+	rusage usage{};
+	if (getrusage(who, &usage) != 0)
+		return {};
+	return { static_cast<uint64_t>(usage.ru_majflt), static_cast<uint64_t>(usage.ru_minflt) };
+#else
+	return {};
+#endif
+}
+
+bool PageFaults::IsPerThread() noexcept {
+#if PLUGIFY_PLATFORM_LINUX
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace plugify {
+	class Prefetcher {
+	public:
+		Prefetcher() = delete;
+
+		// Asks the OS to start reading the whole file into the page cache, returns without waiting for the I/O.
+		// Returns false if the file cannot be opened or the platform has no such hint.
+		static bool Prefetch(const std::filesystem::path& filePath);
+	};
+
+	struct PageFaults {
+		uint64_t major{};
+		uint64_t minor{};
+
+		PageFaults& operator+=(const PageFaults& other) noexcept {
+			major += other.major;
+			minor += other.minor;
+			return *this;
+		}
+
+		PageFaults operator-(const PageFaults& other) const noexcept {
+			return { major - other.major, minor - other.minor };
+		}
+
+		// Counters of the calling thread where the platform tracks them per thread, otherwise of the whole process.
+		// Always zero on Windows.
+		static PageFaults Capture() noexcept;
+
+		// True if Capture reads the counters of the calling thread only.
+		static bool IsPerThread() noexcept;
+	};
+}
@@ -0,0 +1,173 @@
+#include "resource_index.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace plugify;
+
+namespace {
+	constexpr auto kSeparator = static_cast<fs::path::value_type>('/');
+	constexpr auto kDot = static_cast<fs::path::value_type>('.');
+
+	constexpr bool IsSeparator(fs::path::value_type c) noexcept {
+		return c == kSeparator || c == fs::path::preferred_separator;
+	}
+
+	constexpr bool IsParentPrefix(fs::path_view path) noexcept {
+		return path.size() >= 2 && path[0] == kDot && path[1] == kDot;
+	}
+}
+
+ResourceIndex::ResourceIndex(fs::path packageDir, fs::path overrideDir, std::vector<std::string> directories)
+	: _packageDir{std::move(packageDir)}, _overrideDir{std::move(overrideDir)}, _directories{std::move(directories)} {
+}
+
+std::optional<fs::path_view> ResourceIndex::Find(fs::path_view path) const {
+	std::call_once(_built, &ResourceIndex::Build, this);
+
+	const Entry* entry = IsNormalized(path) ? FindEntry(path) : FindEntry(Normalize(path));
+	if (!entry)
+		return {};
+	return GetValue(*entry);
+}
+
+size_t ResourceIndex::GetSize() const {
+	std::call_once(_built, &ResourceIndex::Build, this);
+	return _entries.size();
+}
+
+void ResourceIndex::Build() const {
+	auto makeKey = [](const string_type& prefix, const string_type& root, const string_type& path) {
+		// Directory iterators compose entry paths from the root, so the relative part is a plain suffix
+		size_t offset = std::min(root.size(), path.size());
+		while (offset < path.size() && IsSeparator(path[offset])) {
+			++offset;
+		}
+		string_type key = prefix;
+		if (!key.empty()) {
+			key.push_back(kSeparator);
+		}
+		key.append(path, offset);
+		return Normalize(key);
+	};
+
+	std::error_code ec;
+
+	for (const auto& rawPath : _directories) {
+		fs::path directory = fs::path(rawPath).lexically_normal();
+		string_type prefix = Normalize(directory.native());
+		fs::path root = fs::absolute(_packageDir / directory, ec);
+		if (ec)
+			continue;
+
+		// Walking the override directory once is cheaper than probing it for every file,
+		// unless the resource directory is the package itself or lies outside of it
+		bool walkOverrides = !_overrideDir.empty() && !prefix.empty() && !IsParentPrefix(prefix);
+
+		std::unordered_map<string_type, string_type> overrides;
+		if (walkOverrides) {
+			fs::path overrideRoot = _overrideDir / prefix;
+			for (const auto& entry : fs::recursive_directory_iterator(overrideRoot, ec)) {
+				if (entry.is_regular_file(ec)) {
+					overrides.emplace(makeKey(prefix, overrideRoot.native(), entry.path().native()), entry.path().native());
+				}
+			}
+		}
+
+		for (const auto& entry : fs::recursive_directory_iterator(root, ec)) {
+			if (!entry.is_regular_file(ec))
+				continue;
+
+			string_type key = makeKey(prefix, root.native(), entry.path().native());
+			if (walkOverrides) {
+				auto it = overrides.find(key);
+				Insert(key, it != overrides.end() ? it->second : entry.path().native());
+			} else if (!_overrideDir.empty()) {
+				fs::path overridePath = _overrideDir / key;
+				Insert(key, fs::is_regular_file(overridePath, ec) ? overridePath.native() : entry.path().native());
+			} else {
+				Insert(key, entry.path().native());
+			}
+		}
+	}
+
+	// The first directory listed wins when several of them provide the same file
+	std::stable_sort(_entries.begin(), _entries.end(), [this](const Entry& lhs, const Entry& rhs) {
+		return GetKey(lhs) < GetKey(rhs);
+	});
+	auto last = std::unique(_entries.begin(), _entries.end(), [this](const Entry& lhs, const Entry& rhs) {
+		return GetKey(lhs) == GetKey(rhs);
+	});
+	_entries.erase(last, _entries.end());
+
+	_entries.shrink_to_fit();
+	_pool.shrink_to_fit();
+}
+
+void ResourceIndex::Insert(string_view_type key, string_view_type value) const {
+	auto& entry = _entries.emplace_back();
+	entry.key = static_cast<uint32_t>(_pool.size());
+	entry.keyLength = static_cast<uint32_t>(key.size());
+	_pool.append(key);
+	entry.value = static_cast<uint32_t>(_pool.size());
+	entry.valueLength = static_cast<uint32_t>(value.size());
+	_pool.append(value);
+	// Values are handed out as C strings
+	_pool.push_back(0);
+}
+
+ResourceIndex::string_view_type ResourceIndex::GetKey(const Entry& entry) const noexcept {
+	return { _pool.data() + entry.key, entry.keyLength };
+}
+
+ResourceIndex::string_view_type ResourceIndex::GetValue(const Entry& entry) const noexcept {
+	return { _pool.data() + entry.value, entry.valueLength };
+}
+
+const ResourceIndex::Entry* ResourceIndex::FindEntry(string_view_type key) const noexcept {
+	auto it = std::lower_bound(_entries.begin(), _entries.end(), key, [this](const Entry& entry, string_view_type value) {
+		return GetKey(entry) < value;
+	});
+	if (it == _entries.end() || GetKey(*it) != key)
+		return nullptr;
+	return &*it;
+}
+
+bool ResourceIndex::IsNormalized(string_view_type path) noexcept {
+	size_t start = 0;
+	for (size_t i = 0; i <= path.size(); ++i) {
+		if (i != path.size() && !IsSeparator(path[i]))
+			continue;
+		if (i != path.size() && path[i] != kSeparator)
+			return false;
+		auto segment = path.substr(start, i - start);
+		// An empty first segment is the root of an absolute path
+		if ((segment.empty() && i != 0) || (segment.size() == 1 && segment[0] == kDot))
+			return false;
+		start = i + 1;
+	}
+	return true;
+}
+
+ResourceIndex::string_type ResourceIndex::Normalize(string_view_type path) {
+	string_type result;
+	result.reserve(path.size());
+	if (!path.empty() && IsSeparator(path[0])) {
+		result.push_back(kSeparator);
+	}
+
+	size_t start = 0;
+	for (size_t i = 0; i <= path.size(); ++i) {
+		if (i != path.size() && !IsSeparator(path[i]))
+			continue;
+		auto segment = path.substr(start, i - start);
+		start = i + 1;
+		if (segment.empty() || (segment.size() == 1 && segment[0] == kDot))
+			continue;
+		if (!result.empty() && result.back() != kSeparator) {
+			result.push_back(kSeparator);
+		}
+		result.append(segment);
+	}
+	return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <plugify/path.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace plugify {
+	// Maps resource paths relative to a package onto absolute file paths.
+	// Files with the same relative path inside the override directory take precedence over the package ones.
+	// All strings share one pool and the entries are sorted by key, so a lookup is a binary search without allocations.
+	class ResourceIndex {
+	public:
+		ResourceIndex(std::filesystem::path packageDir, std::filesystem::path overrideDir, std::vector<std::string> directories);
+
+		ResourceIndex(const ResourceIndex&) = delete;
+		ResourceIndex& operator=(const ResourceIndex&) = delete;
+
+		// The directories are walked once, by the first lookup
+		std::optional<std::filesystem::path_view> Find(std::filesystem::path_view path) const;
+		size_t GetSize() const;
+
+	private:
+		using string_type = std::filesystem::path::string_type;
+		using string_view_type = std::filesystem::path_view;
+
+		struct Entry {
+			uint32_t key;
+			uint32_t keyLength;
+			uint32_t value;
+			uint32_t valueLength;
+		};
+
+		void Build() const;
+		void Insert(string_view_type key, string_view_type value) const;
+		string_view_type GetKey(const Entry& entry) const noexcept;
+		string_view_type GetValue(const Entry& entry) const noexcept;
+		const Entry* FindEntry(string_view_type key) const noexcept;
+
+		static bool IsNormalized(string_view_type path) noexcept;
+		static string_type Normalize(string_view_type path);
+
+	private:
+		std::filesystem::path _packageDir;
+		std::filesystem::path _overrideDir;
+		std::vector<std::string> _directories;
+		mutable std::once_flag _built;
+		mutable std::vector<Entry> _entries;
+		mutable string_type _pool;
+	};
+}
@@ -0,0 +1,150 @@
+#include "scan_cache.hpp"
+#include "binary_stream.hpp"
+
+#include <fstream>
+#include <vector>
+
+using namespace plugify;
+
+namespace {
+	constexpr uint32_t kMagic = 0x43534C50; // 'PLSC'
+}
+
+ScanCache::ScanCache(std::filesystem::path filePath) : _filePath(std::move(filePath)) {
+	Load();
+}
+
+ScanCache::~ScanCache() {
+	Save();
+}
+
+std::optional<ScanCache::Entry> ScanCache::Find(uint64_t key) const {
+	std::lock_guard lock(_mutex);
+	auto it = _entries.find(key);
+	if (it == _entries.end())
+		return {};
+	return it->second;
+}
+
+void ScanCache::Store(uint64_t key, const Entry& entry) {
+	std::lock_guard lock(_mutex);
+	_entries.insert_or_assign(key, entry);
+	_dirty = true;
+}
+
+void ScanCache::Remove(uint64_t key) {
+	std::lock_guard lock(_mutex);
+	if (_entries.erase(key)) {
+		_dirty = true;
+	}
+}
+
+bool ScanCache::Load() {
+	std::ifstream is(_filePath, std::ios::binary);
+	if (!is.is_open())
+		return false;
+
+	std::vector<uint8_t> buffer{ std::istreambuf_iterator<char>{is}, std::istreambuf_iterator<char>{} };
+
+	BinaryReader header(buffer);
+	uint32_t magic{}, version{};
+	uint64_t hash{};
+	if (!header.Read(magic) || !header.Read(version) || !header.Read(hash) || magic != kMagic || version != kFormatVersion)
+		return false;
+
+	constexpr size_t kHeaderSize = sizeof(magic) + sizeof(version) + sizeof(hash);
+	auto body = std::span(buffer).subspan(kHeaderSize);
+	if (GetHash(body) != hash)
+		return false;
+
+	BinaryReader reader(body);
+	uint32_t entryCount{};
+	if (!reader.Read(entryCount))
+		return false;
+
+	std::unordered_map<uint64_t, Entry> entries;
+	entries.reserve(entryCount);
+	for (uint32_t i = 0; i < entryCount; ++i) {
+		uint64_t key{};
+		Entry entry;
+		if (!reader.Read(key) || !reader.Read(entry.offset) || !reader.Read(entry.check))
+			return false;
+		entries.emplace(key, entry);
+	}
+	if (!reader.IsEnd())
+		return false;
+
+	std::lock_guard lock(_mutex);
+	_entries = std::move(entries);
+	return true;
+}
+
+bool ScanCache::Save() {
+	std::lock_guard lock(_mutex);
+	if (!_dirty)
+		return true;
+
+	BinaryWriter writer;
+	writer.Write(static_cast<uint32_t>(_entries.size()));
+	for (const auto& [key, entry] : _entries) {
+		writer.Write(key);
+		writer.Write(entry.offset);
+		writer.Write(entry.check);
+	}
+
+	auto body = writer.GetData();
+
+	BinaryWriter header;
+	header.Write(kMagic);
+	header.Write(kFormatVersion);
+	header.Write(GetHash(body));
+
+	// Several processes may share the cache, so a reader never sees a partly written file
+	std::filesystem::path tempPath = _filePath;
+	tempPath += ".tmp";
+	{
+		std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+		if (!os.is_open())
+			return false;
+		os.write(reinterpret_cast<const char*>(header.GetData().data()), static_cast<std::streamsize>(header.GetData().size()));
+		os.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+		if (!os)
+			return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tempPath, _filePath, ec);
+	if (ec) {
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+
+	_dirty = false;
+	return true;
+}
+
+uint64_t ScanCache::GetHash(std::span<const uint8_t> data, uint64_t hash) noexcept {
+	for (uint8_t byte : data) {
+		hash = (hash ^ byte) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+uint64_t ScanCache::GetHash(std::string_view text, uint64_t hash) noexcept {
+	return GetHash({ reinterpret_cast<const uint8_t*>(text.data()), text.size() }, hash);
+}
+
+uint64_t ScanCache::GetFileHash(const std::filesystem::path& filePath) {
+	std::ifstream is(filePath, std::ios::binary);
+	if (!is.is_open())
+		return 0;
+
+	uint64_t hash = kHashSeed;
+	std::vector<char> chunk(1 << 16);
+	while (is) {
+		is.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+		auto count = static_cast<size_t>(is.gcount());
+		hash = GetHash({ reinterpret_cast<const uint8_t*>(chunk.data()), count }, hash);
+	}
+	return hash;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace plugify {
+	// Persistent results of pattern and virtual table scans of one module binary.
+	// Entries hold offsets from the module base, so they stay valid across runs as long as the binary is the same.
+	// The file name carries the identity of the binary, a changed binary gets a new file.
+	class ScanCache {
+	public:
+		struct Entry {
+			uint64_t offset{};  // from the module base
+			uint64_t check{};   // extra value to validate the entry with, depends on the kind of lookup
+		};
+
+		// Loads the file if it exists and is valid, otherwise starts empty
+		explicit ScanCache(std::filesystem::path filePath);
+		// Writes the entries back when they were changed
+		~ScanCache();
+
+		ScanCache(const ScanCache&) = delete;
+		ScanCache& operator=(const ScanCache&) = delete;
+
+		std::optional<Entry> Find(uint64_t key) const;
+		void Store(uint64_t key, const Entry& entry);
+		void Remove(uint64_t key);
+
+		bool Save();
+
+		const std::filesystem::path& GetPath() const noexcept {
+			return _filePath;
+		}
+
+		// FNV-1a, 'hash' chains several calls together
+		static uint64_t GetHash(std::span<const uint8_t> data, uint64_t hash = kHashSeed) noexcept;
+		static uint64_t GetHash(std::string_view text, uint64_t hash = kHashSeed) noexcept;
+		// Hash of the whole file, 0 if it cannot be read
+		static uint64_t GetFileHash(const std::filesystem::path& filePath);
+
+		static inline const char* const kExtension = ".scache";
+		static inline const uint32_t kFormatVersion = 1;
+		static inline const uint64_t kHashSeed = 14695981039346656037ULL;
+
+	private:
+		bool Load();
+
+	private:
+		std::filesystem::path _filePath;
+		std::unordered_map<uint64_t, Entry> _entries;
+		mutable std::mutex _mutex;
+		bool _dirty{};
+	};
+}
@@ -0,0 +1,59 @@
+#include "thread_pool.hpp"
+
+using namespace plugify;
+
+ThreadPool::ThreadPool(size_t threadCount) {
+	threadCount = std::max<size_t>(threadCount, 1);
+	_workers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_taskAvailable.notify_all();
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::Submit(Task task) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_tasks.emplace(std::move(task));
+		++_pending;
+	}
+	_taskAvailable.notify_one();
+}
+
+void ThreadPool::Wait() {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_tasksDone.wait(lock, [this] { return _pending == 0; });
+}
+
+void ThreadPool::WorkerLoop() {
+	while (true) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_taskAvailable.wait(lock, [this] { return _stop || !_tasks.empty(); });
+			if (_stop && _tasks.empty())
+				return;
+			task = std::move(_tasks.front());
+			_tasks.pop();
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_pending == 0) {
+				_tasksDone.notify_all();
+			}
+		}
+	}
+}
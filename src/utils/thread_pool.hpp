@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace plugify {
+	class ThreadPool {
+	public:
+		using Task = std::function<void()>;
+
+		explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		size_t GetThreadCount() const noexcept {
+			return _workers.size();
+		}
+
+		void Submit(Task task);
+
+		// Blocks until every submitted task has finished
+		void Wait();
+
+	private:
+		void WorkerLoop();
+
+	private:
+		std::vector<std::thread> _workers;
+		std::queue<Task> _tasks;
+		std::mutex _mutex;
+		std::condition_variable _taskAvailable;
+		std::condition_variable _tasksDone;
+		size_t _pending{ 0 };
+		bool _stop{ false };
+	};
+}
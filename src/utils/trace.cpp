@@ -0,0 +1,79 @@
+#include "trace.hpp"
+#include <utils/file_system.hpp>
+#include <utils/json.hpp>
+
+using namespace plugify;
+
+void TraceSystem::SetEnabled(bool enabled) {
+	std::lock_guard lock(_mutex);
+	if (!enabled) {
+		_events.clear();
+		_threadIds.clear();
+	} else if (!_enabled) {
+		// Tracing is enabled by the thread which initializes plugify, it is the main one whichever thread records first
+		_threadIds.emplace(std::this_thread::get_id(), 0);
+	}
+	_enabled = enabled;
+}
+
+bool TraceSystem::IsEnabled() noexcept {
+	return _enabled;
+}
+
+void TraceSystem::Record(std::string_view name, std::string_view category, std::string_view target, DateTime start, DateTime end) {
+	std::lock_guard lock(_mutex);
+	if (!_enabled)
+		return;
+
+	auto& event = _events.emplace_back();
+	event.name = name;
+	event.cat = category;
+	event.ph = "X";
+	event.ts = start.AsMicroseconds();
+	event.dur = (end - start).AsMicroseconds();
+	event.pid = 1;
+	event.tid = GetThreadId();
+	if (!target.empty()) {
+		event.args.emplace("target", target);
+	}
+}
+
+bool TraceSystem::Write(const fs::path& filePath) {
+	TraceFile file;
+	file.displayTimeUnit = "ms";
+
+	{
+		std::lock_guard lock(_mutex);
+		if (!_enabled)
+			return false;
+
+		file.traceEvents.reserve(_events.size() + _threadIds.size());
+		file.traceEvents.insert(file.traceEvents.end(), _events.begin(), _events.end());
+
+		// Metadata events give every thread a readable name in the viewer
+		for (const auto& [id, tid] : _threadIds) {
+			auto& event = file.traceEvents.emplace_back();
+			event.name = "thread_name";
+			event.ph = "M";
+			event.pid = 1;
+			event.tid = tid;
+			event.args.emplace("name", tid == 0 ? "Main" : std::format("Worker {}", tid));
+		}
+	}
+
+	std::string buffer;
+	const auto ec = glz::write_json(file, buffer);
+	if (ec) {
+		PL_LOG_ERROR("Trace: '{}' has JSON writing error: {}", filePath.string(), glz::format_error(ec));
+		return false;
+	}
+
+	PL_LOG_DEBUG("Trace with {} event(s) written to '{}'", file.traceEvents.size(), filePath.string());
+	return FileSystem::WriteText(filePath, buffer);
+}
+
+uint32_t TraceSystem::GetThreadId() {
+	// Called with the mutex held, the main thread already has id 0, so workers are numbered from 1
+	auto [it, _] = _threadIds.try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(_threadIds.size()));
+	return it->second;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <utils/date_time.hpp>
+
+namespace plugify {
+	struct TraceEvent {
+		std::string name;
+		std::string cat;
+		std::string ph;
+		uint64_t ts{};
+		uint64_t dur{};
+		uint32_t pid{};
+		uint32_t tid{};
+		std::map<std::string, std::string> args;
+	};
+
+	struct TraceFile {
+		std::vector<TraceEvent> traceEvents;
+		std::string displayTimeUnit;
+	};
+
+	class TraceSystem {
+	public:
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled() noexcept;
+
+		static void Record(std::string_view name, std::string_view category, std::string_view target, DateTime start, DateTime end);
+		static bool Write(const std::filesystem::path& filePath);
+
+	private:
+		static uint32_t GetThreadId();
+
+	private:
+		static inline std::atomic_bool _enabled = false;
+		static inline std::mutex _mutex;
+		static inline std::vector<TraceEvent> _events;
+		static inline std::unordered_map<std::thread::id, uint32_t> _threadIds;
+	};
+
+	class TraceScope {
+	public:
+		TraceScope(std::string_view name, std::string_view category, std::string_view target) noexcept
+			: _name{name}, _category{category}, _target{target}, _enabled{TraceSystem::IsEnabled()} {
+			if (_enabled) {
+				_start = DateTime::Now();
+			}
+		}
+
+		~TraceScope() {
+			if (_enabled) {
+				TraceSystem::Record(_name, _category, _target, _start, DateTime::Now());
+			}
+		}
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+	private:
+		std::string_view _name;
+		std::string_view _category;
+		std::string_view _target;
+		DateTime _start;
+		bool _enabled;
+	};
+}
+
+#define PL_TRACE_SCOPE(name, category, target) plugify::TraceScope _traceScope{name, category, target}
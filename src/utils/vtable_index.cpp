@@ -0,0 +1,77 @@
+#include "vtable_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace plugify;
+
+namespace {
+	bool Contains(std::span<const uint8_t> section, uintptr_t address, size_t size) noexcept {
+		const auto begin = reinterpret_cast<uintptr_t>(section.data());
+		return address >= begin && address <= begin + section.size() && begin + section.size() - address >= size;
+	}
+
+	uintptr_t LoadSlot(uintptr_t address) noexcept {
+		uintptr_t value;
+		std::memcpy(&value, reinterpret_cast<const void*>(address), sizeof(value));
+		return value;
+	}
+
+	// A type name has to end inside the section and start like a mangled <type>: a <source-name>, a nested or std name, or a local name
+	std::string_view GetTypeName(std::span<const uint8_t> names, uintptr_t address) noexcept {
+		if (!Contains(names, address, 1))
+			return {};
+		const auto* begin = reinterpret_cast<const char*>(address);
+		const auto* end = static_cast<const char*>(std::memchr(begin, '\0', static_cast<size_t>(reinterpret_cast<uintptr_t>(names.data() + names.size()) - address)));
+		if (!end)
+			return {};
+		std::string_view name(begin, static_cast<size_t>(end - begin));
+		// GCC marks the names of types with internal linkage with a '*' which is not part of the mangling
+		if (!name.empty() && name.front() == '*')
+			name.remove_prefix(1);
+		if (name.empty())
+			return {};
+		const char first = name.front();
+		if ((first >= '0' && first <= '9') || first == 'N' || first == 'S' || first == 'Z')
+			return name;
+		return {};
+	}
+}
+
+VirtualTableIndex VirtualTableIndex::FromItanium(std::span<const uint8_t> names, std::span<const std::span<const uint8_t>> tables) {
+	VirtualTableIndex index;
+
+	auto isInTables = [&](uintptr_t address, size_t size) {
+		return std::any_of(tables.begin(), tables.end(), [&](std::span<const uint8_t> section) {
+			return Contains(section, address, size);
+		});
+	};
+
+	constexpr size_t kSlot = sizeof(uintptr_t);
+	for (std::span<const uint8_t> section : tables) {
+		const auto begin = reinterpret_cast<uintptr_t>(section.data());
+		const uintptr_t end = begin + section.size();
+		// Tables are pointer aligned, the address point needs one slot after the header
+		for (uintptr_t slot = (begin + kSlot - 1) & ~(kSlot - 1); slot + 3 * kSlot <= end; slot += kSlot) {
+			if (LoadSlot(slot) != 0)
+				continue;
+
+			const uintptr_t typeInfo = LoadSlot(slot + kSlot);
+			if (typeInfo % kSlot != 0 || !isInTables(typeInfo, 2 * kSlot) || LoadSlot(typeInfo) == 0)
+				continue;
+
+			std::string_view name = GetTypeName(names, LoadSlot(typeInfo + kSlot));
+			if (name.empty())
+				continue;
+
+			index._tables.try_emplace(name, slot + 2 * kSlot);
+		}
+	}
+
+	return index;
+}
+
+uintptr_t VirtualTableIndex::Find(std::string_view name) const noexcept {
+	auto it = _tables.find(name);
+	return it != _tables.end() ? it->second : 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+
+namespace plugify {
+	// Maps the mangled type names of a module to the addresses of their virtual tables.
+	// Built in one sweep over the sections holding the tables, so later lookups are a single hash probe.
+	// Names are views into the module, the index must not outlive it.
+	class VirtualTableIndex {
+	public:
+		// Itanium C++ ABI: a primary virtual table starts with {offset-to-top = 0, typeinfo*} and its address point follows,
+		// a typeinfo starts with {vptr, name*}. 'names' is the section holding the type names, 'tables' the sections
+		// holding the tables and typeinfos, in the order to search them. The first table found for a name wins.
+		static VirtualTableIndex FromItanium(std::span<const uint8_t> names, std::span<const std::span<const uint8_t>> tables);
+
+		// 0 if there is no table for the name
+		uintptr_t Find(std::string_view name) const noexcept;
+
+		size_t GetCount() const noexcept {
+			return _tables.size();
+		}
+
+	private:
+		std::unordered_map<std::string_view, uintptr_t> _tables;
+	};
+}
@@ -191,6 +191,7 @@ int main() {
 						CONPRINT("  unload         - Unload plugin manager");
 						CONPRINT("  modules        - List running modules");
 						CONPRINT("  plugins        - List running plugins");
+						CONPRINT("  reload <name>  - Reload plugin and its dependents");
 						CONPRINT("  plugin <name>  - Show information about a module");
 						CONPRINT("  module <name>  - Show information about a plugin");
 						CONPRINT("Plugin Manager options:");
@@ -254,6 +255,22 @@ int main() {
 						}
 					}
 
+					else if (args[1] == "reload") {
+						if (args.size() > 2) {
+							if (!pluginManager->IsInitialized()) {
+								CONPRINT("You must load plugin manager before reload any plugin.");
+								continue;
+							}
+							if (pluginManager->ReloadPlugin(args[2])) {
+								CONPRINTF("Plugin {} was reloaded.", args[2]);
+							} else {
+								CONPRINTF("Plugin {} failed to reload.", args[2]);
+							}
+						} else {
+							CONPRINT("You must provide name.");
+						}
+					}
+
 					else if (args[1] == "plugins") {
 						if (!pluginManager->IsInitialized()) {
 							CONPRINT("You must load plugin manager before query any information from it.");
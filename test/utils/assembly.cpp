@@ -0,0 +1,242 @@
+#include <catch_amalgamated.hpp>
+
+#include <plugify/assembly.hpp>
+
+#if defined(__linux__) && defined(PLUGIFY_TEST_MANY_EXPORTS)
+
+#include <dlfcn.h>
+
+#include <string>
+#include <vector>
+
+using plugify::Assembly;
+using plugify::LoadFlag;
+using plugify::MemAddr;
+
+namespace {
+	constexpr size_t kExportCount = 10000;
+
+	std::vector<std::string> MakeExportNames() {
+		std::vector<std::string> names;
+		names.reserve(kExportCount);
+		for (size_t i = 0; i < kExportCount; ++i) {
+			names.emplace_back("export_" + std::to_string(i));
+		}
+		return names;
+	}
+}
+
+TEST_CASE("batched lookup matches dlsym", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local);
+	REQUIRE(assembly.IsValid());
+
+	auto storage = MakeExportNames();
+	// Symbols of dependencies and unknown names go through the fallback
+	storage.emplace_back("malloc");
+	storage.emplace_back("export_missing");
+	storage.emplace_back("");
+
+	std::vector<std::string_view> names(storage.begin(), storage.end());
+	auto addresses = assembly.GetFunctionsByName(names);
+	REQUIRE(addresses.size() == names.size());
+
+	for (size_t i = 0; i < kExportCount; ++i) {
+		REQUIRE(addresses[i] == MemAddr(dlsym(assembly.GetHandle(), storage[i].c_str())));
+	}
+	REQUIRE(addresses[0].RCast<int(*)()>()() == 0);
+	REQUIRE(addresses[kExportCount - 1].RCast<int(*)()>()() == static_cast<int>(kExportCount - 1));
+	REQUIRE(addresses[kExportCount] == MemAddr(dlsym(assembly.GetHandle(), "malloc")));
+	REQUIRE_FALSE(addresses[kExportCount + 1]);
+	REQUIRE_FALSE(addresses[kExportCount + 2]);
+}
+
+TEST_CASE("batched lookup of an invalid assembly", "[assembly]") {
+	Assembly assembly;
+	std::vector<std::string_view> names{ "export_0" };
+	auto addresses = assembly.GetFunctionsByName(names);
+	REQUIRE(addresses.size() == 1);
+	REQUIRE_FALSE(addresses[0]);
+}
+
+TEST_CASE("sections are read on first lookup", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local, {}, true);
+	REQUIRE(assembly.IsValid());
+
+	auto text = assembly.GetSectionByName(".text");
+	REQUIRE(text.IsValid());
+	REQUIRE(assembly.GetSectionByName(".dynsym").IsValid());
+	REQUIRE_FALSE(assembly.GetSectionByName(".missing").IsValid());
+
+	auto address = assembly.GetFunctionByName("export_42").GetPtr();
+	REQUIRE(address >= text.base.GetPtr());
+	REQUIRE(address < text.base.GetPtr() + text.size);
+
+#if defined(__x86_64__) || defined(__i386__)
+	// The executable section is the default scan range, 'mov eax, 42' is a part of export_42
+	auto [bytes, mask] = Assembly::PatternToMaskedBytes("B8 2A 00 00 00");
+	REQUIRE(assembly.FindPattern(bytes.data(), mask));
+#endif
+}
+
+TEST_CASE("sections which cannot be read set the error", "[assembly]") {
+	// Section headers are read from the file on first lookup, a deleted file leaves only the mapped image
+	auto path = std::filesystem::temp_directory_path() / "plugify_deleted_exports.so";
+	std::filesystem::copy_file(PLUGIFY_TEST_MANY_EXPORTS, path, std::filesystem::copy_options::overwrite_existing);
+	Assembly assembly(path, LoadFlag::Lazy | LoadFlag::Local, {}, true);
+	REQUIRE(assembly.IsValid());
+	REQUIRE(assembly.GetError().empty());
+	std::filesystem::remove(path);
+
+	REQUIRE_FALSE(assembly.GetSectionByName(".text").IsValid());
+	REQUIRE_FALSE(assembly.GetError().empty());
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+TEST_CASE("several patterns are found in one pass", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local, {}, true);
+	REQUIRE(assembly.IsValid());
+
+	// 'mov eax, N' of a few exports, one with a wildcard and one which does not exist
+	std::vector<std::string_view> patterns{ "B8 2A 00 00 00", "B8 0F 27 00 00", "B8 ? 03 00 00", "B8 2A 00 00 00 DE AD BE EF" };
+	auto addresses = assembly.FindPatterns(patterns);
+	REQUIRE(addresses.size() == patterns.size());
+	for (size_t i = 0; i < patterns.size(); ++i) {
+		REQUIRE(addresses[i].GetPtr() == assembly.FindPattern(patterns[i]).GetPtr());
+	}
+	REQUIRE(addresses[1]);
+	REQUIRE_FALSE(addresses[3]);
+}
+#endif
+
+TEST_CASE("parallel scan matches the serial scan", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local, {}, true);
+	REQUIRE(assembly.IsValid());
+
+	for (std::string_view pattern : { "B8 2A 00 00 00", "B8 ? 27 00 00", "B8 2A 00 00 00 DE AD BE EF" }) {
+		auto serial = assembly.FindPattern(pattern);
+		REQUIRE(assembly.FindPattern(Assembly::ParallelScan{}, pattern).GetPtr() == serial.GetPtr());
+		REQUIRE(assembly.FindPattern(Assembly::ParallelScan{ 3 }, pattern).GetPtr() == serial.GetPtr());
+	}
+}
+
+TEST_CASE("all matches of a pattern are yielded in order", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local, {}, true);
+	REQUIRE(assembly.IsValid());
+
+	std::vector<uintptr_t> expected;
+	for (MemAddr address = assembly.FindPattern("B8 ? ? 00 00"); address; address = assembly.FindPattern("B8 ? ? 00 00", address.Offset(1))) {
+		expected.push_back(address.GetPtr());
+	}
+	REQUIRE(expected.size() > 1);
+
+	std::vector<uintptr_t> found;
+	for (MemAddr address : assembly.FindAllPatterns("B8 ? ? 00 00")) {
+		found.push_back(address.GetPtr());
+	}
+	REQUIRE(found == expected);
+
+	REQUIRE(assembly.CountPattern("B8 ? ? 00 00") == expected.size());
+	REQUIRE(assembly.CountPattern("B8 ? ? 00 00", 2) == 2);
+	REQUIRE(assembly.CountPattern("B8 2A 00 00 00 DE AD BE EF") == 0);
+
+	auto range = assembly.FindAllPatterns("B8 2A 00 00 00 DE AD BE EF");
+	REQUIRE(range.begin() == range.end());
+}
+
+TEST_CASE("virtual tables are found through the index", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local, {}, true);
+	REQUIRE(assembly.IsValid());
+
+	auto getTable = [&](const char* factory) {
+		auto make = reinterpret_cast<void* (*)()>(assembly.GetFunctionByName(factory).GetPtr());
+		REQUIRE(make);
+		return *static_cast<uintptr_t*>(make());
+	};
+
+	REQUIRE(assembly.GetVirtualTableByName("ScanCacheTable").GetPtr() == getTable("make_table"));
+	REQUIRE(assembly.GetVirtualTableByName("14ScanCacheTable", true).GetPtr() == getTable("make_table"));
+	REQUIRE(assembly.GetVirtualTableByName("N11vtable_test4BaseE", true).GetPtr() == getTable("make_base"));
+	// The primary table, not the one of the 'Other' base
+	REQUIRE(assembly.GetVirtualTableByName("N11vtable_test7DerivedE", true).GetPtr() == getTable("make_derived"));
+
+	REQUIRE_FALSE(assembly.GetVirtualTableByName("N11vtable_test5OtherE", true) == getTable("make_derived"));
+	REQUIRE_FALSE(assembly.GetVirtualTableByName("Missing"));
+	REQUIRE_FALSE(assembly.GetVirtualTableByName("CacheTable"));
+}
+
+TEST_CASE("build id is read from the note", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local);
+	REQUIRE(assembly.IsValid());
+
+	// Linkers emit a 160 bit SHA-1 build id by default
+	auto buildId = assembly.GetBuildId();
+	REQUIRE(buildId.size() == 40);
+	REQUIRE(buildId.find_first_not_of("0123456789abcdef") == std::string::npos);
+}
+
+TEST_CASE("scan results are cached across runs", "[assembly]") {
+	auto directory = std::filesystem::temp_directory_path() / "plugify_scan_cache_assembly";
+	std::filesystem::remove_all(directory);
+	Assembly::SetScanCacheDirectory(directory);
+
+	auto scan = [] {
+		Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local, {}, true);
+		REQUIRE(assembly.IsValid());
+
+		auto makeTable = reinterpret_cast<void* (*)()>(assembly.GetFunctionByName("make_table").GetPtr());
+		REQUIRE(makeTable);
+		void* object = makeTable();
+		auto table = assembly.GetVirtualTableByName("ScanCacheTable");
+		REQUIRE(table.GetPtr() == *static_cast<uintptr_t*>(object));
+
+#if defined(__x86_64__) || defined(__i386__)
+		auto address = assembly.FindPattern("B8 2A 00 00 00");
+		REQUIRE(address);
+		std::vector<std::string_view> patterns{ "B8 2A 00 00 00", "B8 0F 27 00 00" };
+		auto addresses = assembly.FindPatterns(patterns);
+		REQUIRE(addresses[0].GetPtr() == address.GetPtr());
+		REQUIRE(addresses[1]);
+		return address.GetPtr() - assembly.GetBase().GetPtr();
+#else
+		return uintptr_t{0};
+#endif
+	};
+
+	auto first = scan();
+	// The cache is written when the assembly goes away
+	REQUIRE(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()) == 1);
+	auto second = scan();
+	REQUIRE(first == second);
+
+	Assembly::SetScanCacheDirectory({});
+	std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("sections are not read unless requested", "[assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local);
+	REQUIRE(assembly.IsValid());
+	REQUIRE_FALSE(assembly.GetSectionByName(".text").IsValid());
+}
+
+TEST_CASE("symbol lookup of 10k exports", "[.][benchmark][assembly]") {
+	Assembly assembly(std::filesystem::path(PLUGIFY_TEST_MANY_EXPORTS), LoadFlag::Lazy | LoadFlag::Local);
+	REQUIRE(assembly.IsValid());
+
+	auto storage = MakeExportNames();
+	std::vector<std::string_view> names(storage.begin(), storage.end());
+
+	BENCHMARK("dlsym one by one") {
+		std::vector<MemAddr> addresses;
+		addresses.reserve(names.size());
+		for (const auto& name : names) {
+			addresses.emplace_back(assembly.GetFunctionByName(name));
+		}
+		return addresses;
+	};
+
+	BENCHMARK("GetFunctionsByName") {
+		return assembly.GetFunctionsByName(names);
+	};
+}
+
+#endif // defined(__linux__) && defined(PLUGIFY_TEST_MANY_EXPORTS)
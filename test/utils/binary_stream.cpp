@@ -0,0 +1,79 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/binary_stream.hpp>
+
+using plugify::BinaryReader;
+using plugify::BinaryWriter;
+
+TEST_CASE("binary stream > round trip", "[binary_stream]") {
+	BinaryWriter writer;
+	writer.Write(uint32_t{0xDEADBEEF});
+	writer.Write(int64_t{-42});
+	writer.Write(true);
+	writer.Write(std::string("plugify"));
+	writer.Write(std::vector<std::string>{"a", "", "ccc"});
+	writer.Write(std::optional<int32_t>{7});
+	writer.Write(std::optional<std::vector<std::string>>{});
+
+	BinaryReader reader(writer.GetData());
+	uint32_t u{};
+	int64_t i{};
+	bool b{};
+	std::string str;
+	std::vector<std::string> strs;
+	std::optional<int32_t> opt;
+	std::optional<std::vector<std::string>> optStrs = std::vector<std::string>{"x"};
+
+	REQUIRE(reader.Read(u));
+	REQUIRE(reader.Read(i));
+	REQUIRE(reader.Read(b));
+	REQUIRE(reader.Read(str));
+	REQUIRE(reader.Read(strs));
+	REQUIRE(reader.Read(opt));
+	REQUIRE(reader.Read(optStrs));
+	REQUIRE(reader.IsEnd());
+	REQUIRE_FALSE(reader.IsFailed());
+
+	CHECK(u == 0xDEADBEEF);
+	CHECK(i == -42);
+	CHECK(b);
+	CHECK(str == "plugify");
+	CHECK(strs == std::vector<std::string>{"a", "", "ccc"});
+	CHECK(opt == 7);
+	CHECK_FALSE(optStrs.has_value());
+}
+
+TEST_CASE("binary stream > corrupted data", "[binary_stream]") {
+	SECTION("truncated") {
+		BinaryWriter writer;
+		writer.Write(std::string("truncated"));
+		auto data = writer.GetData();
+
+		BinaryReader reader(data.first(data.size() - 1));
+		std::string str;
+		REQUIRE_FALSE(reader.Read(str));
+		REQUIRE(reader.IsFailed());
+
+		uint8_t byte{};
+		REQUIRE_FALSE(reader.Read(byte));
+	}
+
+	SECTION("huge size") {
+		BinaryWriter writer;
+		writer.Write(uint32_t{0xFFFFFFFF});
+
+		BinaryReader reader(writer.GetData());
+		std::vector<std::string> strs;
+		REQUIRE_FALSE(reader.Read(strs));
+		REQUIRE(strs.empty());
+	}
+
+	SECTION("invalid bool") {
+		BinaryWriter writer;
+		writer.Write(uint8_t{2});
+
+		BinaryReader reader(writer.GetData());
+		bool b{};
+		REQUIRE_FALSE(reader.Read(b));
+	}
+}
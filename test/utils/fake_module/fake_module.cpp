@@ -0,0 +1,91 @@
+#include "fake_module.hpp"
+
+#include <plugify/language_module.hpp>
+#include <plugify/method.hpp>
+#include <plugify/module.hpp>
+#include <plugify/plugin.hpp>
+#include <plugify/plugify_provider.hpp>
+
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace {
+	// Language module without a runtime, it only records what the plugin manager asks it to do
+	class FakeLanguageModule final : public plugify::ILanguageModule {
+	public:
+		plugify::InitResult Initialize(std::weak_ptr<plugify::IPlugifyProvider> provider, plugify::ModuleRef module) override {
+			_provider = std::move(provider);
+			auto& state = fake_module::GetState();
+			int initializing = ++state.initializing;
+			int peak = state.peakInitializing;
+			while (initializing > peak && !state.peakInitializing.compare_exchange_weak(peak, initializing)) {
+			}
+			std::this_thread::sleep_for(state.initializeDelay);
+			--state.initializing;
+			state.Record("init:" + std::string(module.GetName()));
+			if (state.failingModules.contains(module.GetName()))
+				return plugify::ErrorData{ "failed on purpose" };
+			return plugify::InitResultData{};
+		}
+
+		void Shutdown() override {
+		}
+
+		plugify::LoadResult OnPluginLoad(plugify::PluginRef plugin) override {
+			auto& state = fake_module::GetState();
+			std::this_thread::sleep_for(state.pluginDelay);
+			state.Record("load:" + std::string(plugin.GetName()));
+			return plugify::LoadResultData{};
+		}
+
+		void OnPluginStart(plugify::PluginRef plugin) override {
+			auto& state = fake_module::GetState();
+			std::this_thread::sleep_for(state.pluginDelay);
+			auto it = state.resolveOnStart.find(plugin.GetName());
+			if (it != state.resolveOnStart.end()) {
+				if (auto provider = _provider.lock()) {
+					// the method does not exist, the lookup only activates its owner
+					static_cast<void>(provider->ResolveMethod(it->second, "Method"));
+				}
+			}
+			state.Record("start:" + std::string(plugin.GetName()));
+		}
+
+		void OnPluginEnd(plugify::PluginRef plugin) override {
+			fake_module::GetState().Record("end:" + std::string(plugin.GetName()));
+		}
+
+		void OnMethodExport(plugify::PluginRef plugin) override {
+			auto& state = fake_module::GetState();
+			if (state.recordExports) {
+				state.Record("export:" + std::string(plugin.GetName()));
+			}
+		}
+
+		void OnMethodExportBatch(std::span<const plugify::PluginRef> plugins) override {
+			auto& state = fake_module::GetState();
+			if (state.recordExports) {
+				state.Record("batch:" + std::to_string(plugins.size()));
+			}
+		}
+
+		bool IsDebugBuild() override {
+#ifdef NDEBUG
+			return false;
+#else
+			return true;
+#endif
+		}
+
+	private:
+		std::weak_ptr<plugify::IPlugifyProvider> _provider;
+	};
+
+	FakeLanguageModule g_languageModule;
+}
+
+extern "C" plugify::ILanguageModule* GetLanguageModule() {
+	return &g_languageModule;
+}
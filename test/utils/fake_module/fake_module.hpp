@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fake_module {
+	// Shared by every copy of the fake language module and the tests, lives in its own library
+	struct State {
+		std::chrono::milliseconds initializeDelay{};
+		std::chrono::microseconds pluginDelay{};
+		bool recordExports{};
+		std::map<std::string, std::string, std::less<>> resolveOnStart; ///< Plugin to the plugin whose method it resolves from its start
+		std::set<std::string, std::less<>> failingModules;
+		std::atomic_int initializing{};
+		std::atomic_int peakInitializing{};
+		std::mutex mutex;
+		std::vector<std::string> events;
+
+		void Record(std::string event) {
+			std::lock_guard lock(mutex);
+			events.emplace_back(std::move(event));
+		}
+
+		void Reset() {
+			std::lock_guard lock(mutex);
+			initializeDelay = {};
+			pluginDelay = {};
+			recordExports = false;
+			resolveOnStart.clear();
+			failingModules.clear();
+			initializing = 0;
+			peakInitializing = 0;
+			events.clear();
+		}
+	};
+
+	State& GetState();
+}
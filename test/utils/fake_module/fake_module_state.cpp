@@ -0,0 +1,6 @@
+#include "fake_module.hpp"
+
+fake_module::State& fake_module::GetState() {
+	static State state;
+	return state;
+}
@@ -0,0 +1,135 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/graph.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using plugify::Graph;
+
+namespace {
+	// Random DAG with a shuffled node order. Every node depends on up to 'maxDependencies' other nodes.
+	Graph MakeAcyclicGraph(size_t nodeCount, size_t maxDependencies, uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::vector<Graph::Node> order(nodeCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::shuffle(order.begin(), order.end(), rng);
+
+		Graph graph(nodeCount);
+		for (size_t i = 1; i < nodeCount; ++i) {
+			std::uniform_int_distribution<size_t> pick(0, i - 1);
+			const size_t dependencies = std::min(i, maxDependencies);
+			for (size_t j = 0; j < dependencies; ++j) {
+				graph.AddEdge(order[i], order[pick(rng)]);
+			}
+		}
+		return graph;
+	}
+
+	bool IsLoadOrder(const Graph& graph, const std::vector<Graph::Component>& components) {
+		std::vector<size_t> position(graph.GetNodeCount());
+		for (size_t i = 0; i < components.size(); ++i) {
+			for (Graph::Node node : components[i]) {
+				position[node] = i;
+			}
+		}
+		for (Graph::Node node = 0; node < graph.GetNodeCount(); ++node) {
+			for (Graph::Node dependency : graph.GetEdges(node)) {
+				if (position[dependency] > position[node])
+					return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_CASE("graph > strongly connected components", "[graph]") {
+	SECTION("acyclic") {
+		Graph graph(4);
+		graph.AddEdge(0, 1);
+		graph.AddEdge(1, 2);
+		graph.AddEdge(3, 2);
+
+		auto components = graph.GetStronglyConnectedComponents();
+		REQUIRE(components.size() == 4);
+		REQUIRE(IsLoadOrder(graph, components));
+		for (const auto& component : components) {
+			REQUIRE_FALSE(graph.IsCyclic(component));
+		}
+	}
+
+	SECTION("cycles") {
+		Graph graph(6);
+		graph.AddEdge(0, 1);
+		graph.AddEdge(1, 2);
+		graph.AddEdge(2, 0);
+		graph.AddEdge(3, 0);
+		graph.AddEdge(4, 4);
+		graph.AddEdge(5, 3);
+
+		auto components = graph.GetStronglyConnectedComponents();
+		REQUIRE(components.size() == 4);
+		REQUIRE(IsLoadOrder(graph, components));
+
+		std::vector<Graph::Component> cycles;
+		std::copy_if(components.begin(), components.end(), std::back_inserter(cycles), [&](const auto& component) {
+			return graph.IsCyclic(component);
+		});
+		REQUIRE(cycles.size() == 2);
+		REQUIRE(std::find(cycles.begin(), cycles.end(), Graph::Component{ 0, 1, 2 }) != cycles.end());
+		REQUIRE(std::find(cycles.begin(), cycles.end(), Graph::Component{ 4 }) != cycles.end());
+	}
+
+	SECTION("deep chain") {
+		// Would overflow the stack with a recursive DFS
+		constexpr size_t kNodeCount = 50000;
+		Graph graph(kNodeCount);
+		for (Graph::Node node = 0; node + 1 < kNodeCount; ++node) {
+			graph.AddEdge(node, node + 1);
+		}
+
+		auto components = graph.GetStronglyConnectedComponents();
+		REQUIRE(components.size() == kNodeCount);
+		REQUIRE(components.front() == Graph::Component{ kNodeCount - 1 });
+		REQUIRE(components.back() == Graph::Component{ 0 });
+	}
+}
+
+TEST_CASE("graph > scaling", "[graph]") {
+	for (size_t nodeCount : { 1000, 10000, 50000 }) {
+		DYNAMIC_SECTION("acyclic " << nodeCount) {
+			Graph graph = MakeAcyclicGraph(nodeCount, 8, static_cast<uint32_t>(nodeCount));
+
+			auto components = graph.GetStronglyConnectedComponents();
+			REQUIRE(components.size() == nodeCount);
+			REQUIRE(IsLoadOrder(graph, components));
+		}
+
+		DYNAMIC_SECTION("cyclic " << nodeCount) {
+			Graph graph = MakeAcyclicGraph(nodeCount, 8, static_cast<uint32_t>(nodeCount));
+			// Close a ring over the first hundred nodes
+			for (Graph::Node node = 0; node < 100; ++node) {
+				graph.AddEdge(node, (node + 1) % 100);
+			}
+
+			auto components = graph.GetStronglyConnectedComponents();
+			REQUIRE(IsLoadOrder(graph, components));
+			auto cyclic = std::count_if(components.begin(), components.end(), [&](const auto& component) {
+				return graph.IsCyclic(component);
+			});
+			REQUIRE(cyclic >= 1);
+			REQUIRE(std::any_of(components.begin(), components.end(), [](const auto& component) {
+				return component.size() >= 100;
+			}));
+		}
+	}
+}
+
+TEST_CASE("graph > benchmark", "[.][benchmark][graph]") {
+	Graph graph = MakeAcyclicGraph(50000, 8, 42);
+
+	BENCHMARK("strongly connected components 50k") {
+		return graph.GetStronglyConnectedComponents();
+	};
+}
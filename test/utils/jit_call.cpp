@@ -0,0 +1,411 @@
+#include <catch_amalgamated.hpp>
+
+#include <plugify/jit/call.hpp>
+#include <plugify/jit/callback.hpp>
+#include <plugify/jit/helpers.hpp>
+#include <plugify/math.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define JIT_CALL_HAS_RDTSC 1
+#endif
+
+using plugify::JitCall;
+using plugify::JitCallback;
+using plugify::MemAddr;
+using plugify::MethodRef;
+using plugify::ValueType;
+using plugify::Vector2;
+using plugify::Vector3;
+using plugify::Vector4;
+using plugify::JitUtils::GetRetTypeId;
+using plugify::JitUtils::GetValueTypeId;
+
+namespace {
+	int64_t Mix(int8_t a, float b, double c, const char* d) { return a + static_cast<int64_t>(b * c) + d[0]; }
+
+	int counter = 0;
+	void Increment() { ++counter; }
+
+	double stored = 0;
+	void Store(int a, double b, int64_t c, float d) { stored = a + b + static_cast<double>(c) + d; }
+
+	int Add(int a, int b) { return a + b; }
+	int64_t sink = 0;
+	void Accumulate(int a, int b) { sink += a + b; }
+
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+	float Weigh(Vector2 a, Vector3 b, int c, Vector4 d) {
+		return a.x + a.y * 10 + b.x * 100 + b.y * 1000 + b.z * 10000 + static_cast<float>(c) + d.x + d.y + d.z + d.w;
+	}
+
+	Vector3 Cross(Vector3 a, Vector3 b) {
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	// Vectors passed by value reach the handler as a pointer in their slot
+	void ScaleHandler(MethodRef, MemAddr, const JitCallback::Parameters* params, uint8_t count, const JitCallback::Return* ret) {
+		REQUIRE(count == 2);
+		const auto* v = params->GetArgument<const Vector3*>(0);
+		const float scale = params->GetArgument<float>(1);
+		ret->SetReturn((v->x + v->y + v->z) * scale);
+	}
+#else
+	float ScaleByPointer(const Vector3* v, float scale) {
+		return (v->x + v->y + v->z) * scale;
+	}
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
+
+	int64_t Sum(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9,
+				int a10, int a11, int a12, int a13, int a14, int a15, int a16, int a17, int a18, int a19) {
+		return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12 + a13 + a14 + a15 + a16 + a17 + a18 + a19;
+	}
+}
+
+TEST_CASE("parameters are stored in 64bit slots", "[jit_call]") {
+	JitCall::Parameters params(3);
+	params.AddArgument(uint8_t{0xFF});
+	params.AddArgument(-1);
+	params.AddArgument(2.5);
+
+	REQUIRE(params.GetCount() == 3);
+	const uint64_t* data = params.GetDataPtr();
+	REQUIRE(data[0] == 0xFF);
+	REQUIRE(data[1] == 0xFFFFFFFF);
+	REQUIRE(*reinterpret_cast<const double*>(&data[2]) == 2.5);
+}
+
+TEST_CASE("parameters larger than the inline block", "[jit_call]") {
+	JitCall::Parameters params(static_cast<uint8_t>(JitCall::kInlineParameters + 4));
+	for (int i = 0; i < static_cast<int>(JitCall::kInlineParameters) + 4; ++i) {
+		params.AddArgument(i);
+	}
+
+	// the block stays valid when moved
+	JitCall::Parameters moved = std::move(params);
+	REQUIRE(moved.GetCount() == JitCall::kInlineParameters + 4);
+	REQUIRE(moved.GetDataPtr()[JitCall::kInlineParameters + 3] == JitCall::kInlineParameters + 3);
+}
+
+TEST_CASE("parameters are copied with their storage", "[jit_call]") {
+	JitCall::Parameters small(2);
+	small.AddArgument(1);
+	JitCall::Parameters smallCopy = small;
+	smallCopy.AddArgument(2);
+	REQUIRE(small.GetCount() == 1);
+	REQUIRE(smallCopy.GetCount() == 2);
+	REQUIRE(smallCopy.GetDataPtr()[0] == 1);
+	REQUIRE(smallCopy.GetDataPtr()[1] == 2);
+
+	JitCall::Parameters large(static_cast<uint8_t>(JitCall::kInlineParameters + 1));
+	for (int i = 0; i < static_cast<int>(JitCall::kInlineParameters) + 1; ++i) {
+		large.AddArgument(i);
+	}
+	JitCall::Parameters largeCopy(1);
+	largeCopy = large;
+	REQUIRE(largeCopy.GetCount() == JitCall::kInlineParameters + 1);
+	REQUIRE(largeCopy.GetDataPtr() != large.GetDataPtr());
+	REQUIRE(largeCopy.GetDataPtr()[JitCall::kInlineParameters] == JitCall::kInlineParameters);
+}
+
+TEST_CASE("parameters grow past the count", "[jit_call]") {
+	JitCall::Parameters params(1);
+	for (int i = 0; i < static_cast<int>(JitCall::kInlineParameters) * 2 + 3; ++i) {
+		params.AddArgument(i);
+	}
+	REQUIRE(params.GetCount() == JitCall::kInlineParameters * 2 + 3);
+	for (size_t i = 0; i < params.GetCount(); ++i) {
+		REQUIRE(params.GetDataPtr()[i] == i);
+	}
+
+	JitCall::BasicParameters<2> small(2);
+	small.AddArgument(1.5);
+	small.AddArgument(2);
+	small.AddArgument(int64_t{1} << 40);
+	REQUIRE(small.GetCount() == 3);
+	REQUIRE(*reinterpret_cast<const double*>(&small.GetDataPtr()[0]) == 1.5);
+	REQUIRE(small.GetDataPtr()[2] == uint64_t{1} << 40);
+
+	JitCall::BasicParameters<2> moved = std::move(small);
+	REQUIRE(moved.GetCount() == 3);
+	REQUIRE(small.GetCount() == 0);
+	small.AddArgument(3);
+	small.AddArgument(4);
+	small.AddArgument(5);
+	REQUIRE(small.GetDataPtr()[2] == 5);
+}
+
+TEST_CASE("invoke packs the arguments of the signature", "[jit_call]") {
+	auto rt = std::make_shared<asmjit::JitRuntime>();
+
+	JitCall mix(rt);
+	REQUIRE(mix.GetJitFunc(asmjit::FuncSignature::build<int64_t, int8_t, float, double, const char*>(), (void*) &Mix, JitCall::WaitType::None, false));
+	REQUIRE(JitCall::Invoke<int64_t(int8_t, float, double, const char*)>(mix.GetFunction(), -2, 1.5f, 4.0, "A") == 'A' + 4);
+
+	JitCall increment(rt);
+	REQUIRE(increment.GetJitFunc(asmjit::FuncSignature::build<void>(), (void*) &Increment, JitCall::WaitType::None, false));
+	JitCall::Invoke<void()>(increment.GetFunction());
+	REQUIRE(counter == 1);
+
+	JitCall sum(rt);
+	asmjit::FuncSignature sig(asmjit::CallConvId::kCDecl, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kInt64);
+	for (int i = 0; i < 20; ++i) {
+		sig.addArgT<int>();
+	}
+	REQUIRE(sum.GetJitFunc(sig, (void*) &Sum, JitCall::WaitType::None, false));
+	JitCall::Parameters params(20);
+	for (int i = 0; i < 20; ++i) {
+		params.AddArgument(i);
+	}
+	JitCall::Return ret;
+	sum.GetFunction().RCast<JitCall::CallingFunc>()(params.GetDataPtr(), &ret);
+	REQUIRE(ret.GetReturn<int64_t>() == 190);
+}
+
+TEST_CASE("void targets get every argument", "[jit_call]") {
+	auto rt = std::make_shared<asmjit::JitRuntime>();
+
+	JitCall store(rt);
+	REQUIRE(store.GetJitFunc(asmjit::FuncSignature::build<void, int, double, int64_t, float>(), (void*) &Store, JitCall::WaitType::None, false));
+	JitCall::Invoke<void(int, double, int64_t, float)>(store.GetFunction(), 1, 0.5, int64_t{1} << 40, 0.25f);
+	REQUIRE(stored == 1.75 + static_cast<double>(int64_t{1} << 40));
+}
+
+#if PLUGIFY_JIT_TAIL_STUBS
+TEST_CASE("void targets get the tail stub", "[jit_call]") {
+	const auto sig = asmjit::FuncSignature::build<void, int, int>();
+
+	auto emit = [&](JitCall::WaitType waitType) {
+		asmjit::CodeHolder code;
+		code.init(asmjit::Environment::host());
+		auto cc = plugify::JitUtils::CreateCompiler(code);
+		const char* error = nullptr;
+		REQUIRE(JitCall::EmitStub(*cc, sig, (void*) &Accumulate, waitType, false, error).isValid());
+		REQUIRE(cc->finalize() == asmjit::kErrorOk);
+		const asmjit::CodeBuffer& buffer = code.textSection()->buffer();
+		return std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size());
+	};
+
+	// a breakpoint needs the full stub
+	const std::vector<uint8_t> tail = emit(JitCall::WaitType::None);
+	const std::vector<uint8_t> full = emit(JitCall::WaitType::Breakpoint);
+	REQUIRE(tail.size() < full.size());
+
+#if defined(__x86_64__) || defined(_M_X64)
+	// ends with jmp r11
+	const std::vector<uint8_t> jump{ 0x41, 0xFF, 0xE3 };
+	REQUIRE(std::equal(jump.rbegin(), jump.rend(), tail.rbegin()));
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	// ends with br x16
+	const std::vector<uint8_t> jump{ 0x00, 0x02, 0x1F, 0xD6 };
+	REQUIRE(std::equal(jump.rbegin(), jump.rend(), tail.rbegin()));
+#endif
+}
+#endif // PLUGIFY_JIT_TAIL_STUBS
+
+TEST_CASE("call cycles per call", "[.][benchmark][jit_call]") {
+	constexpr size_t kCalls = 10'000'000;
+
+	auto rt = std::make_shared<asmjit::JitRuntime>();
+	JitCall add(rt);
+	JitCall accumulate(rt);
+	REQUIRE(add.GetJitFunc(asmjit::FuncSignature::build<int, int, int>(), (void*) &Add, JitCall::WaitType::None, false));
+	REQUIRE(accumulate.GetJitFunc(asmjit::FuncSignature::build<void, int, int>(), (void*) &Accumulate, JitCall::WaitType::None, false));
+
+	auto measure = [&](const char* name, auto&& call) {
+		call();
+		auto start = std::chrono::steady_clock::now();
+#if JIT_CALL_HAS_RDTSC
+		const uint64_t cycles = __rdtsc();
+#endif
+		for (size_t i = 0; i < kCalls; ++i) {
+			call();
+		}
+#if JIT_CALL_HAS_RDTSC
+		const double perCall = static_cast<double>(__rdtsc() - cycles) / kCalls;
+#endif
+		auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		std::cout << name << ": " << elapsed / kCalls << " ns"
+#if JIT_CALL_HAS_RDTSC
+				  << ", " << perCall << " reference cycles"
+#endif
+				  << " per call" << std::endl;
+	};
+
+	// through a volatile pointer, so the direct call is not inlined
+	int (*volatile direct)(int, int) = &Add;
+	int64_t sum = 0;
+	measure("direct call", [&] { sum += direct(3, 2); });
+	measure("JitCall::Invoke, full stub", [&] { sum += JitCall::Invoke<int(int, int)>(add.GetFunction(), 3, 2); });
+	measure("JitCall::Invoke, void target", [&] { JitCall::Invoke<void(int, int)>(accumulate.GetFunction(), 3, 2); });
+
+	JitCall::Parameters params(2);
+	params.AddArgument(3);
+	params.AddArgument(2);
+	JitCall::Return ret;
+	auto func = add.GetFunction().RCast<JitCall::CallingFunc>();
+	measure("CallingFunc, prepacked", [&] { func(params.GetDataPtr(), &ret); sum += ret.GetReturn<int>(); });
+
+	REQUIRE(sum != 0);
+	REQUIRE(sink != 0);
+}
+
+#if PLUGIFY_JIT_VECTOR_BY_VALUE
+TEST_CASE("vectors are passed by value", "[jit_call]") {
+	auto rt = std::make_shared<asmjit::JitRuntime>();
+
+	asmjit::FuncSignature weighSig(asmjit::CallConvId::kCDecl, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kFloat32);
+	weighSig.addArg(GetValueTypeId(ValueType::Vector2));
+	weighSig.addArg(GetValueTypeId(ValueType::Vector3));
+	weighSig.addArg(GetValueTypeId(ValueType::Int32));
+	weighSig.addArg(GetValueTypeId(ValueType::Vector4));
+
+	JitCall weigh(rt);
+	REQUIRE(weigh.GetJitFunc(weighSig, (void*) &Weigh, JitCall::WaitType::None, false));
+
+	// the slot of a vector holds a pointer to it
+	const Vector2 a{ 1, 2 };
+	const Vector3 b{ 3, 4, 5 };
+	const Vector4 d{ 0.5f, 0.25f, 0.125f, 0.0625f };
+	REQUIRE(JitCall::Invoke<float(const Vector2*, const Vector3*, int, const Vector4*)>(weigh.GetFunction(), &a, &b, 6, &d) == Weigh(a, b, 6, d));
+
+#if !PLUGIFY_PLATFORM_WINDOWS
+	asmjit::FuncSignature crossSig(asmjit::CallConvId::kCDecl, asmjit::FuncSignature::kNoVarArgs, GetRetTypeId(ValueType::Vector3));
+	crossSig.addArg(GetValueTypeId(ValueType::Vector3));
+	crossSig.addArg(GetValueTypeId(ValueType::Vector3));
+
+	JitCall cross(rt);
+	REQUIRE(cross.GetJitFunc(crossSig, (void*) &Cross, JitCall::WaitType::None, false));
+
+	const Vector3 x{ 1, 0, 0 };
+	const Vector3 y{ 0, 1, 0 };
+	JitCall::Parameters params(2);
+	params.AddArgument(&x);
+	params.AddArgument(&y);
+	JitCall::Return ret;
+	cross.GetFunction().RCast<JitCall::CallingFunc>()(params.GetDataPtr(), &ret);
+	const auto* z = reinterpret_cast<const Vector3*>(ret.GetReturnPtr());
+	REQUIRE(z->x == 0);
+	REQUIRE(z->y == 0);
+	REQUIRE(z->z == 1);
+#endif // !PLUGIFY_PLATFORM_WINDOWS
+
+	asmjit::FuncSignature scaleSig(asmjit::CallConvId::kCDecl, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kFloat32);
+	scaleSig.addArg(GetValueTypeId(ValueType::Vector3));
+	scaleSig.addArg(GetValueTypeId(ValueType::Float));
+
+	JitCallback scale(rt);
+	auto scaled = scale.GetJitFunc(scaleSig, MethodRef{}, &ScaleHandler, nullptr, false).RCast<float (*)(Vector3, float)>();
+	REQUIRE(scaled);
+	REQUIRE(scaled(Vector3{ 1, 2, 3 }, 0.5f) == 3.0f);
+}
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !PLUGIFY_PLATFORM_WINDOWS
+TEST_CASE("vectors split between registers and stack are rejected", "[jit_call]") {
+	const char* error = nullptr;
+	asmjit::FuncSignature expanded;
+	std::vector<plugify::JitUtils::ArgPart> parts;
+
+	// seven doubles take xmm0-xmm6, the two eightbytes of a vector do not fit xmm7
+	for (ValueType vector : { ValueType::Vector3, ValueType::Vector4 }) {
+		asmjit::FuncSignature sig(asmjit::CallConvId::kX64SystemV, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kVoid);
+		for (int i = 0; i < 7; ++i) {
+			sig.addArgT<double>();
+		}
+		sig.addArg(GetValueTypeId(vector));
+		REQUIRE_FALSE(plugify::JitUtils::ExpandSignature(sig, asmjit::Environment::host(), expanded, parts, error));
+		REQUIRE(std::string_view(error) == "Vector argument split between registers and stack");
+
+		auto rt = std::make_shared<asmjit::JitRuntime>();
+		JitCall call(rt);
+		REQUIRE_FALSE(call.GetJitFunc(sig, (void*) &Weigh, JitCall::WaitType::None, false));
+		REQUIRE(call.GetError() == "Vector argument split between registers and stack");
+	}
+
+	// with eight doubles the whole vector goes to the stack, which is the layout of its eightbytes
+	asmjit::FuncSignature sig(asmjit::CallConvId::kX64SystemV, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kVoid);
+	for (int i = 0; i < 8; ++i) {
+		sig.addArgT<double>();
+	}
+	sig.addArg(GetValueTypeId(ValueType::Vector4));
+	REQUIRE(plugify::JitUtils::ExpandSignature(sig, asmjit::Environment::host(), expanded, parts, error));
+	REQUIRE(parts.size() == 10);
+	REQUIRE(expanded.argCount() == 10);
+}
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+TEST_CASE("vectors are passed as homogeneous float aggregates", "[jit_call]") {
+	const char* error = nullptr;
+	asmjit::FuncSignature expanded;
+	std::vector<plugify::JitUtils::ArgPart> parts;
+
+	asmjit::FuncSignature sig(asmjit::CallConvId::kHost, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kVoid);
+	sig.addArg(GetValueTypeId(ValueType::Vector3));
+	sig.addArgT<float>();
+	REQUIRE(plugify::JitUtils::ExpandSignature(sig, asmjit::Environment::host(), expanded, parts, error));
+
+	// one s register per element, then the float
+	REQUIRE(parts.size() == 4);
+	for (uint32_t i = 0; i < 3; ++i) {
+		REQUIRE(parts[i].type == asmjit::TypeId::kFloat32);
+		REQUIRE(parts[i].arg == 0);
+		REQUIRE(parts[i].offset == sizeof(float) * i);
+		REQUIRE(parts[i].size == sizeof(float));
+	}
+	REQUIRE(parts[3].arg == 1);
+	REQUIRE(parts[3].size == 0);
+
+	asmjit::FuncDetail detail;
+	REQUIRE(detail.init(expanded, asmjit::Environment::host()) == asmjit::kErrorOk);
+	for (uint32_t i = 0; i < 4; ++i) {
+		REQUIRE(detail.arg(i).isReg());
+		REQUIRE(detail.arg(i).regId() == i);
+	}
+
+	// a Vector4 after four floats takes s4-s7 exactly
+	asmjit::FuncSignature fits(asmjit::CallConvId::kHost, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kVoid);
+	for (int i = 0; i < 4; ++i) {
+		fits.addArgT<float>();
+	}
+	fits.addArg(GetValueTypeId(ValueType::Vector4));
+	REQUIRE(plugify::JitUtils::ExpandSignature(fits, asmjit::Environment::host(), expanded, parts, error));
+
+	// a Vector3 after six floats would go to the stack, which the aggregate layout does not match
+	asmjit::FuncSignature spills(asmjit::CallConvId::kHost, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kVoid);
+	for (int i = 0; i < 6; ++i) {
+		spills.addArgT<float>();
+	}
+	spills.addArg(GetValueTypeId(ValueType::Vector3));
+	REQUIRE_FALSE(plugify::JitUtils::ExpandSignature(spills, asmjit::Environment::host(), expanded, parts, error));
+	REQUIRE(std::string_view(error) == "Vector argument does not fit the remaining registers");
+}
+#endif
+#else
+TEST_CASE("vectors are passed by pointer", "[jit_call]") {
+	REQUIRE(GetValueTypeId(ValueType::Vector2) == asmjit::TypeId::kUIntPtr);
+	REQUIRE(GetValueTypeId(ValueType::Vector3) == asmjit::TypeId::kUIntPtr);
+	REQUIRE(GetValueTypeId(ValueType::Vector4) == asmjit::TypeId::kUIntPtr);
+
+	auto rt = std::make_shared<asmjit::JitRuntime>();
+
+	asmjit::FuncSignature sig(asmjit::CallConvId::kCDecl, asmjit::FuncSignature::kNoVarArgs, asmjit::TypeId::kFloat32);
+	sig.addArg(GetValueTypeId(ValueType::Vector3));
+	sig.addArgT<float>();
+	JitCall scale(rt);
+	REQUIRE(scale.GetJitFunc(sig, (void*) &ScaleByPointer, JitCall::WaitType::None, false));
+
+	const Vector3 v{ 1.0f, 2.0f, 3.0f };
+	REQUIRE(JitCall::Invoke<float(const Vector3*, float)>(scale.GetFunction(), &v, 2.0f) == 12.0f);
+}
+#endif // PLUGIFY_JIT_VECTOR_BY_VALUE
@@ -0,0 +1,350 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/pattern_scanner.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <emmintrin.h>
+#define PLUGIFY_TEST_SSE2 1
+#endif
+
+using plugify::Pattern;
+using plugify::PatternSet;
+using plugify::ScanKernel;
+
+namespace {
+	constexpr ScanKernel kKernels[] = { ScanKernel::Scalar, ScanKernel::SSE2, ScanKernel::AVX2, ScanKernel::AVX512 };
+
+	// Mostly common opcode bytes, so anchors still get false positives to verify
+	std::vector<uint8_t> MakeBuffer(size_t size, uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> common(0, 7);
+		std::uniform_int_distribution<int> any(0, 255);
+		constexpr uint8_t kCommon[] = { 0x00, 0xFF, 0x48, 0x8B, 0x89, 0xE8, 0x0F, 0x24 };
+		std::vector<uint8_t> buffer(size);
+		for (auto& byte : buffer) {
+			byte = rng() % 4 ? kCommon[common(rng)] : static_cast<uint8_t>(any(rng));
+		}
+		return buffer;
+	}
+
+	const uint8_t* FindNaive(const uint8_t* begin, const uint8_t* end, const std::vector<uint8_t>& bytes, const std::string& mask) {
+		if (static_cast<size_t>(end - begin) < bytes.size())
+			return nullptr;
+		for (const uint8_t* data = begin; data <= end - bytes.size(); ++data) {
+			bool found = true;
+			for (size_t i = 0; i < bytes.size() && found; ++i) {
+				found = mask[i] != 'x' || data[i] == bytes[i];
+			}
+			if (found)
+				return data;
+		}
+		return nullptr;
+	}
+
+#if PLUGIFY_TEST_SSE2
+	// The loop Assembly::FindPattern used before the anchored kernels, kept as the baseline
+	const uint8_t* FindLegacy(const uint8_t* pData, const uint8_t* pEnd, const uint8_t* pPattern, const std::string& mask) {
+		std::array<int, 64> masks = {};
+		const size_t maskLen = mask.length();
+		const size_t numMasks = (maskLen + 15) / 16;
+		for (size_t i = 0; i < numMasks; ++i) {
+			for (size_t j = 0; j < std::min<size_t>(maskLen - i * 16, 16); ++j) {
+				if (mask[i * 16 + j] == 'x') {
+					masks[i] |= 1 << j;
+				}
+			}
+		}
+
+		pEnd -= maskLen;
+		const __m128i xmm1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPattern));
+		for (; pData != pEnd; _mm_prefetch(reinterpret_cast<const char*>(++pData + 64), _MM_HINT_NTA)) {
+			__m128i msks = _mm_cmpeq_epi8(xmm1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData)));
+			if ((_mm_movemask_epi8(msks) & masks[0]) == masks[0]) {
+				bool found = true;
+				for (size_t i = 1; i < numMasks; ++i) {
+					__m128i xmm2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i * 16));
+					__m128i xmm3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPattern + i * 16));
+					msks = _mm_cmpeq_epi8(xmm2, xmm3);
+					if ((_mm_movemask_epi8(msks) & masks[i]) != masks[i]) {
+						found = false;
+						break;
+					}
+				}
+				if (found)
+					return pData;
+			}
+		}
+		return nullptr;
+	}
+#endif // PLUGIFY_TEST_SSE2
+
+	struct TestPattern {
+		std::vector<uint8_t> bytes;
+		std::string mask;
+	};
+
+	// Cut from the buffer with a few wildcards, every other one changed so that most of them are not found
+	std::vector<TestPattern> MakePatterns(const std::vector<uint8_t>& buffer, size_t count, size_t minLength, size_t maxLength, uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::vector<TestPattern> patterns;
+		for (size_t i = 0; i < count; ++i) {
+			size_t length = minLength + rng() % (maxLength - minLength + 1);
+			size_t offset = rng() % (buffer.size() - length);
+			TestPattern& pattern = patterns.emplace_back();
+			pattern.bytes.assign(buffer.begin() + static_cast<ptrdiff_t>(offset), buffer.begin() + static_cast<ptrdiff_t>(offset + length));
+			pattern.mask.assign(length, 'x');
+			for (auto& c : pattern.mask) {
+				if (rng() % 4 == 0)
+					c = '?';
+			}
+			if (i % 2) {
+				pattern.bytes[rng() % length] ^= 0x5A;
+			}
+		}
+		return patterns;
+	}
+
+	PatternSet MakePatternSet(const std::vector<TestPattern>& patterns) {
+		std::vector<Pattern> compiled;
+		for (const auto& pattern : patterns) {
+			compiled.emplace_back(pattern.bytes, pattern.mask);
+		}
+		return PatternSet(std::move(compiled));
+	}
+
+	template<typename Func>
+	double MeasureThroughput(size_t bytes, Func&& func) {
+		constexpr int kRuns = 5;
+		auto best = std::chrono::duration<double>::max();
+		for (int i = 0; i < kRuns; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			func();
+			best = std::min<std::chrono::duration<double>>(best, std::chrono::steady_clock::now() - start);
+		}
+		return static_cast<double>(bytes) / best.count() / 1e9;
+	}
+}
+
+TEST_CASE("every kernel agrees with a naive scan", "[pattern_scanner]") {
+	auto buffer = MakeBuffer(1 << 16, 1234);
+	std::mt19937 rng(42);
+
+	for (int iteration = 0; iteration < 300; ++iteration) {
+		size_t length = 1 + rng() % 40;
+		size_t offset = rng() % (buffer.size() - length);
+		std::vector<uint8_t> bytes(buffer.begin() + static_cast<ptrdiff_t>(offset), buffer.begin() + static_cast<ptrdiff_t>(offset + length));
+		std::string mask(length, 'x');
+		for (auto& c : mask) {
+			if (rng() % 4 == 0)
+				c = '?';
+		}
+		// Every other pattern is changed, so most of them are not found at all
+		if (iteration % 2) {
+			bytes[rng() % length] ^= 0x5A;
+		}
+
+		const Pattern pattern(bytes, mask);
+		const uint8_t* begin = buffer.data() + rng() % 64;
+		const uint8_t* end = buffer.data() + buffer.size() - rng() % 64;
+		const uint8_t* expected = FindNaive(begin, end, bytes, mask);
+
+		for (ScanKernel kernel : kKernels) {
+			if (!Pattern::IsSupported(kernel))
+				continue;
+			REQUIRE(pattern.Find(begin, end, kernel) == expected);
+		}
+	}
+}
+
+TEST_CASE("pattern scanner edge cases", "[pattern_scanner]") {
+	std::vector<uint8_t> buffer(300, 0x90);
+	buffer.back() = 0xC3;
+
+	for (ScanKernel kernel : kKernels) {
+		if (!Pattern::IsSupported(kernel))
+			continue;
+
+		const uint8_t* begin = buffer.data();
+		const uint8_t* end = begin + buffer.size();
+
+		// Match at the very last position
+		REQUIRE(Pattern(std::vector<uint8_t>{ 0x90, 0xC3 }, "xx").Find(begin, end, kernel) == end - 2);
+		// Wildcards only, matches at once
+		REQUIRE(Pattern(std::vector<uint8_t>{ 0x00, 0x00 }, "??").Find(begin, end, kernel) == begin);
+		// Longer than the range
+		REQUIRE(Pattern(std::vector<uint8_t>(301, 0x90), std::string(301, 'x')).Find(begin, end, kernel) == nullptr);
+		REQUIRE(Pattern(std::vector<uint8_t>{ 0x90 }, "x").Find(begin, begin, kernel) == nullptr);
+
+		// Patterns longer than 1024 bytes are fine as well
+		std::vector<uint8_t> large(4096, 0xCC);
+		large.back() = 0x11;
+		REQUIRE(Pattern(large, std::string(large.size(), 'x')).Find(large.data(), large.data() + large.size(), kernel) == large.data());
+	}
+}
+
+TEST_CASE("parallel scan returns the serial match", "[pattern_scanner]") {
+	auto buffer = MakeBuffer(1 << 16, 321);
+	auto patterns = MakePatterns(buffer, 100, 1, 24, 9);
+	const uint8_t* begin = buffer.data();
+	const uint8_t* end = begin + buffer.size();
+
+	for (const auto& [bytes, mask] : patterns) {
+		const Pattern pattern(bytes, mask);
+		const uint8_t* expected = pattern.Find(begin, end);
+		// Small chunks, so matches cross chunk boundaries and several chunks have hits
+		for (size_t chunkSize : { size_t{1}, size_t{7}, size_t{4096} }) {
+			REQUIRE(pattern.FindParallel(begin, end, 4, chunkSize) == expected);
+		}
+	}
+
+	// A match which starts in one chunk and ends in the next
+	std::vector<uint8_t> data(64, 0x90);
+	data[30] = 0x11;
+	data[31] = 0x22;
+	data[32] = 0x33;
+	const Pattern pattern(std::vector<uint8_t>{ 0x11, 0x22, 0x33 }, "xxx");
+	REQUIRE(pattern.FindParallel(data.data(), data.data() + data.size(), 3, 16) == data.data() + 30);
+}
+
+TEST_CASE("pattern count includes overlapping matches", "[pattern_scanner]") {
+	std::vector<uint8_t> buffer(64, 0x90);
+	const uint8_t* begin = buffer.data();
+	const uint8_t* end = begin + buffer.size();
+
+	const Pattern pattern(std::vector<uint8_t>{ 0x90, 0x90 }, "xx");
+	REQUIRE(pattern.Count(begin, end) == buffer.size() - 1);
+	REQUIRE(pattern.Count(begin, end, 2) == 2);
+	REQUIRE(pattern.Count(begin, end, 0) == 0);
+	REQUIRE(Pattern(std::vector<uint8_t>{ 0xC3 }, "x").Count(begin, end) == 0);
+}
+
+TEST_CASE("pattern set agrees with a naive scan", "[pattern_scanner]") {
+	auto buffer = MakeBuffer(1 << 14, 99);
+	auto patterns = MakePatterns(buffer, 200, 1, 24, 5);
+	const PatternSet patternSet = MakePatternSet(patterns);
+
+	const uint8_t* begin = buffer.data() + 3;
+	const uint8_t* end = buffer.data() + buffer.size() - 5;
+
+	std::vector<PatternSet::Match> expected;
+	std::vector<const uint8_t*> expectedFirst;
+	for (size_t i = 0; i < patterns.size(); ++i) {
+		const auto& [bytes, mask] = patterns[i];
+		expectedFirst.push_back(FindNaive(begin, end, bytes, mask));
+		for (const uint8_t* found = expectedFirst.back(); found; found = FindNaive(found + 1, end, bytes, mask)) {
+			expected.push_back({ i, found });
+		}
+	}
+	std::sort(expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.address != rhs.address ? lhs.address < rhs.address : lhs.index < rhs.index;
+	});
+
+	auto matches = patternSet.FindAll(begin, end);
+	REQUIRE(matches.size() == expected.size());
+	for (size_t i = 0; i < matches.size(); ++i) {
+		REQUIRE(matches[i].index == expected[i].index);
+		REQUIRE(matches[i].address == expected[i].address);
+	}
+	REQUIRE(patternSet.FindFirst(begin, end) == expectedFirst);
+}
+
+TEST_CASE("pattern set edge cases", "[pattern_scanner]") {
+	std::vector<uint8_t> buffer(100, 0x90);
+	buffer.back() = 0xC3;
+	const uint8_t* begin = buffer.data();
+	const uint8_t* end = begin + buffer.size();
+
+	std::vector<Pattern> patterns;
+	// No adjacent fixed bytes, keyed by a single byte
+	patterns.emplace_back(std::vector<uint8_t>{ 0x90, 0x00, 0xC3 }, "x?x");
+	// Single fixed byte at the very last position
+	patterns.emplace_back(std::vector<uint8_t>{ 0xC3 }, "x");
+	// Wildcards only
+	patterns.emplace_back(std::vector<uint8_t>{ 0x00, 0x00 }, "??");
+	// Longer than the range
+	patterns.emplace_back(std::vector<uint8_t>(101, 0x90), std::string(101, 'x'));
+	const PatternSet patternSet(std::move(patterns));
+
+	auto first = patternSet.FindFirst(begin, end);
+	REQUIRE(first == std::vector<const uint8_t*>{ end - 3, end - 1, begin, nullptr });
+	REQUIRE(patternSet.FindAll(begin, end).size() == 1 + 1 + 99);
+	REQUIRE(patternSet.FindAll(begin, begin).empty());
+	REQUIRE(PatternSet(std::vector<Pattern>{}).FindFirst(begin, end).empty());
+}
+
+TEST_CASE("pattern scan throughput", "[.][benchmark][pattern_scanner]") {
+	auto buffer = MakeBuffer(64 << 20, 7);
+	const uint8_t* begin = buffer.data();
+	const uint8_t* end = begin + buffer.size();
+
+	// Not present, so the whole buffer is scanned
+	std::vector<uint8_t> bytes{ 0x48, 0x8B, 0x05, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xC0, 0x74, 0x00, 0xE8, 0x13, 0x37 };
+	std::string mask = "xxx????xxxx?xxx";
+	const Pattern pattern(bytes, mask);
+	REQUIRE(FindNaive(begin, end, bytes, mask) == nullptr);
+
+#if PLUGIFY_TEST_SSE2
+	bytes.resize(64);
+	std::cout << "legacy SSE2: " << MeasureThroughput(buffer.size(), [&] { REQUIRE(FindLegacy(begin, end, bytes.data(), mask) == nullptr); }) << " GB/s" << std::endl;
+#endif // PLUGIFY_TEST_SSE2
+
+	constexpr const char* kNames[] = { "scalar", "SSE2", "AVX2", "AVX-512" };
+	for (ScanKernel kernel : kKernels) {
+		if (!Pattern::IsSupported(kernel))
+			continue;
+		std::cout << kNames[static_cast<size_t>(kernel)] << ": " << MeasureThroughput(buffer.size(), [&] { REQUIRE(pattern.Find(begin, end, kernel) == nullptr); }) << " GB/s" << std::endl;
+	}
+}
+
+TEST_CASE("parallel pattern scan throughput", "[.][benchmark][pattern_scanner]") {
+	auto buffer = MakeBuffer(256 << 20, 13);
+	const uint8_t* begin = buffer.data();
+	const uint8_t* end = begin + buffer.size();
+
+	// Only present at the very end, so every chunk before it is scanned
+	std::vector<uint8_t> bytes{ 0x48, 0x8B, 0x05, 0x13, 0x37, 0xC0, 0xDE, 0x48, 0x85, 0xC0 };
+	std::copy(bytes.begin(), bytes.end(), buffer.end() - static_cast<ptrdiff_t>(bytes.size()));
+	const Pattern pattern(bytes, std::string(bytes.size(), 'x'));
+
+	const uint8_t* expected = pattern.Find(begin, end);
+	REQUIRE(expected == end - bytes.size());
+	std::cout << "serial: " << MeasureThroughput(buffer.size(), [&] { REQUIRE(pattern.Find(begin, end) == expected); }) << " GB/s" << std::endl;
+	for (size_t threadCount : { size_t{2}, size_t{4}, size_t{8} }) {
+		std::cout << threadCount << " threads: " << MeasureThroughput(buffer.size(), [&] { REQUIRE(pattern.FindParallel(begin, end, threadCount) == expected); }) << " GB/s" << std::endl;
+	}
+}
+
+TEST_CASE("pattern set throughput", "[.][benchmark][pattern_scanner]") {
+	auto buffer = MakeBuffer(16 << 20, 11);
+	auto patterns = MakePatterns(buffer, 300, 12, 32, 17);
+	const uint8_t* begin = buffer.data();
+	const uint8_t* end = begin + buffer.size();
+
+	std::vector<Pattern> compiled;
+	for (const auto& pattern : patterns) {
+		compiled.emplace_back(pattern.bytes, pattern.mask);
+	}
+	const PatternSet patternSet(compiled);
+
+	std::vector<const uint8_t*> expected;
+	double separate = MeasureThroughput(buffer.size(), [&] {
+		expected.clear();
+		for (const auto& pattern : compiled) {
+			expected.push_back(pattern.Find(begin, end));
+		}
+	});
+	std::cout << "300 patterns, one scan each: " << separate << " GB/s" << std::endl;
+
+	std::vector<const uint8_t*> found;
+	double single = MeasureThroughput(buffer.size(), [&] {
+		found = patternSet.FindFirst(begin, end);
+	});
+	std::cout << "300 patterns, one pattern set scan: " << single << " GB/s" << std::endl;
+	REQUIRE(found == expected);
+}
@@ -0,0 +1,389 @@
+#include <catch_amalgamated.hpp>
+
+#if defined(__linux__) && defined(PLUGIFY_TEST_FAKE_MODULE)
+
+#include <fake_module/fake_module.hpp>
+#include <plugify/log.hpp>
+#include <plugify/module.hpp>
+#include <plugify/package_manager.hpp>
+#include <plugify/plugify.hpp>
+#include <plugify/plugin.hpp>
+#include <plugify/plugin_manager.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+using plugify::PluginState;
+
+namespace {
+	// Real plugify instance over a temporary base directory, every module is a copy of the fake language module
+	class FakeEnvironment {
+	public:
+		explicit FakeEnvironment(std::string_view name) : _root(std::filesystem::temp_directory_path() / name) {
+			std::filesystem::remove_all(_root);
+			std::filesystem::create_directories(_root / "base");
+			fake_module::GetState().Reset();
+		}
+
+		~FakeEnvironment() {
+			Stop();
+			std::error_code ec;
+			std::filesystem::remove_all(_root, ec);
+		}
+
+		void AddModule(const std::string& name, bool threadSafe = false, bool batchMethodExport = false) {
+			auto directory = _root / "base" / "modules" / name;
+			std::filesystem::create_directories(directory / "bin");
+			std::filesystem::copy_file(PLUGIFY_TEST_FAKE_MODULE, directory / "bin" / ("lib" + name + ".so"));
+			Write(directory / (name + ".pmodule"), "{\"fileVersion\": 1, \"version\": 1, \"friendlyName\": \"" + name + "\", \"language\": \"" + name + "\", \"threadSafe\": " + (threadSafe ? "true" : "false") + ", \"batchMethodExport\": " + (batchMethodExport ? "true" : "false") + "}");
+		}
+
+		void AddPlugin(const std::string& name, const std::vector<std::string>& dependencies = {}, bool lazy = false, const std::string& module = "fake") {
+			auto directory = _root / "base" / "plugins" / name;
+			std::filesystem::create_directories(directory);
+			std::string references;
+			for (const auto& dependency : dependencies) {
+				references += (references.empty() ? "{\"name\": \"" : ", {\"name\": \"") + dependency + "\"}";
+			}
+			Write(directory / (name + ".pplugin"), "{\"fileVersion\": 1, \"version\": 1, \"friendlyName\": \"" + name + "\", \"entryPoint\": \"bin/" + name + "\", \"languageModule\": {\"name\": \"" + module + "\"}, \"dependencies\": [" + references + "], \"lazy\": " + (lazy ? "true" : "false") + "}");
+		}
+
+		plugify::IPluginManager& Start(bool parallelLoad = false) {
+			Stop();
+			Write(_root / "plugify.pconfig", std::string("{\"baseDir\": \"base\", \"preferOwnSymbols\": false, \"parallelLoad\": ") + (parallelLoad ? "true" : "false") + "}");
+			_plugify = plugify::MakePlugify();
+			if (_logger) {
+				_plugify->SetLogger(_logger);
+			}
+			REQUIRE(_plugify->Initialize(_root));
+			REQUIRE(_plugify->GetPackageManager().lock()->Initialize());
+			auto pluginManager = _plugify->GetPluginManager().lock();
+			REQUIRE(pluginManager->Initialize());
+			return *pluginManager;
+		}
+
+		void SetLogger(std::shared_ptr<plugify::ILogger> logger) {
+			_logger = std::move(logger);
+		}
+
+		void Stop() {
+			if (_plugify) {
+				_plugify->Terminate();
+				_plugify.reset();
+			}
+		}
+
+		PluginState GetState(std::string_view name) const {
+			auto plugin = _plugify->GetPluginManager().lock()->FindPlugin(name);
+			REQUIRE(plugin.has_value());
+			return plugin->GetState();
+		}
+
+		plugify::UniqueId GetId(std::string_view name) const {
+			auto plugin = _plugify->GetPluginManager().lock()->FindPlugin(name);
+			REQUIRE(plugin.has_value());
+			return plugin->GetId();
+		}
+
+		static std::vector<std::string> TakeEvents() {
+			auto& state = fake_module::GetState();
+			std::lock_guard lock(state.mutex);
+			return std::exchange(state.events, {});
+		}
+
+	private:
+		static void Write(const std::filesystem::path& path, const std::string& text) {
+			std::ofstream os(path, std::ios::trunc);
+			os << text;
+		}
+
+		std::filesystem::path _root;
+		std::shared_ptr<plugify::IPlugify> _plugify;
+		std::shared_ptr<plugify::ILogger> _logger;
+	};
+
+	class ErrorLog final : public plugify::ILogger {
+	public:
+		void Log(std::string_view msg, plugify::Severity severity) override {
+			if (severity == plugify::Severity::Error) {
+				std::lock_guard lock(_mutex);
+				_errors.emplace_back(msg);
+			}
+		}
+
+		std::vector<std::string> Take() {
+			std::lock_guard lock(_mutex);
+			return std::exchange(_errors, {});
+		}
+
+	private:
+		std::mutex _mutex;
+		std::vector<std::string> _errors;
+	};
+}
+
+TEST_CASE("reload keeps a plugin whose dependency stays running", "[plugin_manager]") {
+	FakeEnvironment environment("plugify_reload_running_dependency");
+	environment.AddModule("fake");
+	environment.AddPlugin("a");
+	environment.AddPlugin("b", { "a" });
+	environment.AddPlugin("c", { "b" });
+
+	auto& pluginManager = environment.Start();
+	REQUIRE(environment.GetState("c") == PluginState::Running);
+	FakeEnvironment::TakeEvents();
+
+	REQUIRE(pluginManager.ReloadPlugin("b"));
+	REQUIRE(environment.GetState("a") == PluginState::Running);
+	REQUIRE(environment.GetState("b") == PluginState::Running);
+	REQUIRE(environment.GetState("c") == PluginState::Running);
+
+	// Only the reloaded subgraph is ended and loaded again, the running dependency is left alone
+	REQUIRE(FakeEnvironment::TakeEvents() == std::vector<std::string>{ "end:c", "end:b", "load:b", "load:c", "start:b", "start:c" });
+}
+
+TEST_CASE("reload keeps ids and refuses a dependency which comes later", "[plugin_manager]") {
+	FakeEnvironment environment("plugify_reload_new_dependency");
+	environment.AddModule("fake");
+	environment.AddPlugin("p");
+	environment.AddPlugin("q");
+
+	auto& pluginManager = environment.Start();
+	FakeEnvironment::TakeEvents();
+
+	// Independent plugins keep any order, so the earlier one is made to depend on the later one
+	bool pFirst = environment.GetId("p") < environment.GetId("q");
+	std::string first = pFirst ? "p" : "q";
+	std::string second = pFirst ? "q" : "p";
+	const plugify::UniqueId firstId = environment.GetId(first);
+	const plugify::UniqueId secondId = environment.GetId(second);
+	environment.AddPlugin(first, { second });
+
+	// Nothing is stopped and the ids handed out before stay valid
+	REQUIRE_FALSE(pluginManager.ReloadPlugin(first));
+	REQUIRE(environment.GetState(first) == PluginState::Running);
+	REQUIRE(environment.GetState(second) == PluginState::Running);
+	REQUIRE(environment.GetId(first) == firstId);
+	REQUIRE(environment.GetId(second) == secondId);
+	REQUIRE(pluginManager.FindPluginFromId(firstId)->GetName() == first);
+	REQUIRE(FakeEnvironment::TakeEvents().empty());
+
+	// The new order is applied on the next start
+	environment.Start();
+	REQUIRE(environment.GetState(first) == PluginState::Running);
+	REQUIRE(environment.GetId(second) < environment.GetId(first));
+}
+
+TEST_CASE("reload activates a lazy plugin the new descriptor requires", "[plugin_manager]") {
+	FakeEnvironment environment("plugify_reload_lazy_dependency");
+	environment.AddModule("fake");
+	environment.AddPlugin("a");
+	environment.AddPlugin("l", {}, true);
+
+	auto& pluginManager = environment.Start();
+	REQUIRE(environment.GetState("l") == PluginState::NotLoaded);
+	FakeEnvironment::TakeEvents();
+
+	environment.AddPlugin("a", { "l" });
+
+	REQUIRE(pluginManager.ReloadPlugin("a"));
+	REQUIRE(environment.GetState("l") == PluginState::Running);
+	REQUIRE(FakeEnvironment::TakeEvents() == std::vector<std::string>{ "end:a", "load:l", "load:a", "start:l", "start:a" });
+}
+
+TEST_CASE("lazy plugin activates after startup on top of a running dependency", "[plugin_manager]") {
+	FakeEnvironment environment("plugify_activate_running_dependency");
+	environment.AddModule("fake");
+	environment.AddPlugin("a");
+	environment.AddPlugin("l", { "a" }, true);
+
+	auto& pluginManager = environment.Start();
+	REQUIRE(environment.GetState("a") == PluginState::Running);
+	REQUIRE(environment.GetState("l") == PluginState::NotLoaded);
+	FakeEnvironment::TakeEvents();
+
+	REQUIRE(pluginManager.ActivatePlugin("l"));
+	REQUIRE(environment.GetState("a") == PluginState::Running);
+	REQUIRE(environment.GetState("l") == PluginState::Running);
+	REQUIRE(FakeEnvironment::TakeEvents() == std::vector<std::string>{ "load:l", "start:l" });
+}
+
+TEST_CASE("lazy plugin activated during startup starts its loaded dependency first", "[plugin_manager]") {
+	FakeEnvironment environment("plugify_activate_loaded_dependency");
+	environment.AddModule("fake");
+	environment.AddPlugin("s");
+	environment.AddPlugin("d", { "s" });
+	environment.AddPlugin("l", { "d" }, true);
+
+	// s starts before d, which is loaded but not running when s asks for l
+	fake_module::GetState().resolveOnStart.emplace("s", "l");
+
+	environment.Start();
+	REQUIRE(environment.GetState("s") == PluginState::Running);
+	REQUIRE(environment.GetState("d") == PluginState::Running);
+	REQUIRE(environment.GetState("l") == PluginState::Running);
+	REQUIRE(FakeEnvironment::TakeEvents() == std::vector<std::string>{ "init:fake", "load:s", "load:d", "load:l", "start:d", "start:l", "start:s" });
+}
+
+TEST_CASE("methods are exported in one batch only to modules which ask for it", "[plugin_manager]") {
+	FakeEnvironment environment("plugify_batch_method_export");
+	environment.AddModule("fake");
+	environment.AddModule("batched", false, true);
+	environment.AddPlugin("a");
+	environment.AddPlugin("b", { "a" });
+	fake_module::GetState().recordExports = true;
+
+	environment.Start();
+	std::vector<std::string> exports;
+	for (auto& event : FakeEnvironment::TakeEvents()) {
+		if (event.starts_with("export:") || event.starts_with("batch:")) {
+			exports.emplace_back(std::move(event));
+		}
+	}
+	std::sort(exports.begin(), exports.end());
+	REQUIRE(exports == std::vector<std::string>{ "batch:2", "export:a", "export:b" });
+}
+
+TEST_CASE("language modules initialize concurrently and report errors in module order", "[plugin_manager]") {
+	FakeEnvironment environment("plugify_parallel_modules");
+	for (size_t i = 0; i < 6; ++i) {
+		auto module = "fake_" + std::to_string(i);
+		environment.AddModule(module);
+		environment.AddPlugin("plugin_" + std::to_string(i), {}, false, module);
+	}
+
+	auto& state = fake_module::GetState();
+	state.initializeDelay = std::chrono::milliseconds(20);
+	state.failingModules = { "fake_1", "fake_3", "fake_5" };
+
+	auto log = std::make_shared<ErrorLog>();
+	environment.SetLogger(log);
+
+	environment.Start(false);
+	auto serialErrors = log->Take();
+	REQUIRE(state.peakInitializing == 1);
+	state.peakInitializing = 0;
+
+	auto& pluginManager = environment.Start(true);
+	auto parallelErrors = log->Take();
+
+	// Every module sleeps while it initializes, so modules on different workers overlap
+	if (std::thread::hardware_concurrency() > 1) {
+		REQUIRE(state.peakInitializing > 1);
+	}
+
+	// Errors follow the module order, not the order in which the workers finished
+	std::vector<std::string> expected;
+	for (const auto& module : pluginManager.GetModules()) {
+		if (state.failingModules.contains(module.GetName())) {
+			expected.emplace_back("Module '" + std::string(module.GetName()) + "'");
+		}
+	}
+	std::erase_if(parallelErrors, [](const std::string& error) { return !error.starts_with("Module '"); });
+	REQUIRE(parallelErrors.size() == expected.size());
+	for (size_t i = 0; i < expected.size(); ++i) {
+		REQUIRE(parallelErrors[i].starts_with(expected[i]));
+	}
+	std::erase_if(serialErrors, [](const std::string& error) { return !error.starts_with("Module '"); });
+	REQUIRE(parallelErrors == serialErrors);
+}
+
+TEST_CASE("plugin startup", "[.][benchmark][plugin_manager]") {
+	// 10 levels of 20 plugins, every plugin depends on one plugin of the previous level
+	FakeEnvironment environment("plugify_startup_benchmark");
+	environment.AddModule("fake", true);
+	for (size_t i = 0; i < 200; ++i) {
+		environment.AddPlugin("plugin_" + std::to_string(i), i < 20 ? std::vector<std::string>{} : std::vector<std::string>{ "plugin_" + std::to_string(i - 20) });
+	}
+	fake_module::GetState().pluginDelay = std::chrono::microseconds(200);
+
+	BENCHMARK("serial, 200 plugins x 200us") {
+		environment.Start(false);
+		environment.Stop();
+		return FakeEnvironment::TakeEvents().size();
+	};
+
+	BENCHMARK("parallel, 200 plugins x 200us") {
+		environment.Start(true);
+		environment.Stop();
+		return FakeEnvironment::TakeEvents().size();
+	};
+}
+
+TEST_CASE("plugin lookup", "[.][benchmark][plugin_manager]") {
+	FakeEnvironment environment("plugify_lookup_benchmark");
+	environment.AddModule("fake");
+	for (size_t i = 0; i < 10000; ++i) {
+		environment.AddPlugin("plugin_" + std::to_string(i));
+	}
+
+	auto& pluginManager = environment.Start();
+	auto plugins = pluginManager.GetPlugins();
+	REQUIRE(plugins.size() == 10000);
+
+	std::vector<std::string> names;
+	for (size_t i = 0; i < 10000; i += 97) {
+		names.emplace_back("plugin_" + std::to_string(i));
+	}
+
+	// The linear scan is what every lookup did before the indices
+	BENCHMARK("linear scan by name, 10k plugins") {
+		size_t found = 0;
+		for (const auto& name : names) {
+			found += std::ranges::find(plugins, std::string_view(name), &plugify::PluginRef::GetName) != plugins.end();
+		}
+		return found;
+	};
+
+	BENCHMARK("FindPlugin, 10k plugins") {
+		size_t found = 0;
+		for (const auto& name : names) {
+			found += pluginManager.FindPlugin(name).has_value();
+		}
+		return found;
+	};
+
+	BENCHMARK("FindPluginFromId, 10k plugins") {
+		size_t found = 0;
+		for (plugify::UniqueId id = 0; id < 10000; id += 97) {
+			found += pluginManager.FindPluginFromId(id).has_value();
+		}
+		return found;
+	};
+
+	BENCHMARK("FindModuleFromLang, 10k plugins") {
+		size_t found = 0;
+		for (size_t i = 0; i < names.size(); ++i) {
+			found += pluginManager.FindModuleFromLang("fake").has_value();
+		}
+		return found;
+	};
+}
+
+TEST_CASE("language module startup", "[.][benchmark][plugin_manager]") {
+	FakeEnvironment environment("plugify_module_startup_benchmark");
+	for (size_t i = 0; i < 8; ++i) {
+		auto module = "fake_" + std::to_string(i);
+		environment.AddModule(module);
+		environment.AddPlugin("plugin_" + std::to_string(i), {}, false, module);
+	}
+	fake_module::GetState().initializeDelay = std::chrono::milliseconds(50);
+
+	BENCHMARK("serial, 8 modules x 50ms") {
+		environment.Start(false);
+		environment.Stop();
+		return FakeEnvironment::TakeEvents().size();
+	};
+
+	BENCHMARK("parallel, 8 modules x 50ms") {
+		environment.Start(true);
+		environment.Stop();
+		return FakeEnvironment::TakeEvents().size();
+	};
+}
+
+#endif
@@ -0,0 +1,40 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/prefetch.hpp>
+
+#include <fstream>
+#include <vector>
+
+using plugify::PageFaults;
+using plugify::Prefetcher;
+
+TEST_CASE("prefetch fails for a missing file", "[prefetch]") {
+	REQUIRE_FALSE(Prefetcher::Prefetch(std::filesystem::temp_directory_path() / "plugify_missing_binary.so"));
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+TEST_CASE("prefetch accepts a regular file", "[prefetch]") {
+	auto path = std::filesystem::temp_directory_path() / "plugify_prefetch_test.bin";
+	{
+		std::ofstream os(path, std::ios::binary);
+		std::vector<char> data(64 * 1024, 'x');
+		os.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	REQUIRE(Prefetcher::Prefetch(path));
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("page fault counters grow when new memory is touched", "[prefetch]") {
+	auto start = PageFaults::Capture();
+
+	std::vector<char> memory(32 * 1024 * 1024);
+	for (size_t i = 0; i < memory.size(); i += 4096) {
+		memory[i] = 1;
+	}
+
+	auto faults = PageFaults::Capture() - start;
+	REQUIRE(faults.minor + faults.major > 0);
+}
+#endif
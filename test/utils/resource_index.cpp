@@ -0,0 +1,66 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/resource_index.hpp>
+
+#include <fstream>
+
+using plugify::ResourceIndex;
+
+namespace {
+	void CreateFile(const std::filesystem::path& path) {
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream os(path);
+		os << path.filename().string();
+	}
+
+	std::filesystem::path FindPath(const ResourceIndex& index, const std::filesystem::path& path) {
+		auto result = index.Find(path.native());
+		return result ? std::filesystem::path(*result) : std::filesystem::path();
+	}
+}
+
+TEST_CASE("resource index maps package paths onto files", "[resource_index]") {
+	auto root = std::filesystem::temp_directory_path() / "plugify_resource_index_test";
+	std::filesystem::remove_all(root);
+
+	auto packageDir = root / "plugins" / "sample";
+	auto overrideDir = root / "base";
+
+	CreateFile(packageDir / "configs" / "core.cfg");
+	CreateFile(packageDir / "configs" / "sub" / "extra.cfg");
+	CreateFile(packageDir / "data" / "blob.bin");
+	CreateFile(overrideDir / "configs" / "core.cfg");
+	CreateFile(overrideDir / "configs" / "unknown.cfg");
+
+	ResourceIndex index(packageDir, overrideDir, { "configs", "./data/" });
+
+	// Nothing is read before the first lookup
+	CreateFile(packageDir / "data" / "late.bin");
+
+	SECTION("package files are found by their relative path") {
+		REQUIRE(index.GetSize() == 4);
+		REQUIRE(FindPath(index, "configs/sub/extra.cfg") == packageDir / "configs" / "sub" / "extra.cfg");
+		REQUIRE(FindPath(index, "data/blob.bin") == packageDir / "data" / "blob.bin");
+		REQUIRE(FindPath(index, "data/late.bin") == packageDir / "data" / "late.bin");
+	}
+
+	SECTION("override files take precedence, but do not add resources") {
+		REQUIRE(FindPath(index, "configs/core.cfg") == overrideDir / "configs" / "core.cfg");
+		REQUIRE_FALSE(index.Find(std::filesystem::path("configs/unknown.cfg").native()));
+	}
+
+	SECTION("lookups ignore redundant separators and dots") {
+		REQUIRE(FindPath(index, "./configs//sub/./extra.cfg") == packageDir / "configs" / "sub" / "extra.cfg");
+		REQUIRE(FindPath(index, "data/blob.bin/") == packageDir / "data" / "blob.bin");
+		REQUIRE_FALSE(index.Find(std::filesystem::path("blob.bin").native()));
+		REQUIRE_FALSE(index.Find(std::filesystem::path("/data/blob.bin").native()));
+	}
+
+	std::filesystem::remove_all(root);
+}
+
+TEST_CASE("resource index without directories is empty", "[resource_index]") {
+	ResourceIndex index(std::filesystem::temp_directory_path() / "plugify_missing_package", {}, { "configs" });
+	REQUIRE(index.GetSize() == 0);
+	REQUIRE_FALSE(index.Find(std::filesystem::path("configs/core.cfg").native()));
+}
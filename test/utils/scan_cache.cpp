@@ -0,0 +1,75 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/scan_cache.hpp>
+
+#include <fstream>
+#include <vector>
+
+using plugify::ScanCache;
+
+namespace {
+	std::filesystem::path GetCachePath() {
+		return std::filesystem::temp_directory_path() / "plugify_scan_cache_test.scache";
+	}
+}
+
+TEST_CASE("scan cache entries survive a reload", "[scan_cache]") {
+	auto path = GetCachePath();
+	std::filesystem::remove(path);
+
+	{
+		ScanCache cache(path);
+		REQUIRE_FALSE(cache.Find(1));
+		cache.Store(1, { 0x1000, 0 });
+		cache.Store(2, { 0x2000, 0x30 });
+		cache.Store(3, { 0x3000, 0 });
+		cache.Remove(3);
+	}
+
+	{
+		ScanCache cache(path);
+		auto first = cache.Find(1);
+		auto second = cache.Find(2);
+		REQUIRE(first);
+		REQUIRE(first->offset == 0x1000);
+		REQUIRE(second);
+		REQUIRE(second->offset == 0x2000);
+		REQUIRE(second->check == 0x30);
+		REQUIRE_FALSE(cache.Find(3));
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("scan cache ignores a damaged file", "[scan_cache]") {
+	auto path = GetCachePath();
+	std::filesystem::remove(path);
+
+	{
+		ScanCache cache(path);
+		cache.Store(1, { 0x1000, 0 });
+	}
+
+	std::vector<char> data;
+	{
+		std::ifstream is(path, std::ios::binary);
+		data.assign(std::istreambuf_iterator<char>{is}, std::istreambuf_iterator<char>{});
+	}
+	REQUIRE(data.size() > 16);
+	data.back() ^= 0x5A;
+	{
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		os.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	ScanCache cache(path);
+	REQUIRE_FALSE(cache.Find(1));
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("scan cache hashes chain", "[scan_cache]") {
+	REQUIRE(ScanCache::GetHash("ab") == ScanCache::GetHash("b", ScanCache::GetHash("a")));
+	REQUIRE(ScanCache::GetHash("ab") != ScanCache::GetHash("ba"));
+	REQUIRE(ScanCache::GetFileHash(std::filesystem::temp_directory_path() / "plugify_missing_scan_cache_input") == 0);
+}
@@ -0,0 +1,34 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/thread_pool.hpp>
+
+#include <atomic>
+
+using plugify::ThreadPool;
+
+TEST_CASE("thread pool runs every submitted task before wait returns", "[thread_pool]") {
+	ThreadPool threadPool(4);
+	REQUIRE(threadPool.GetThreadCount() == 4);
+
+	std::atomic_int counter = 0;
+	for (int i = 0; i < 1000; ++i) {
+		threadPool.Submit([&counter] { ++counter; });
+	}
+	threadPool.Wait();
+	REQUIRE(counter == 1000);
+
+	// The pool stays usable after a wait
+	threadPool.Submit([&counter] { ++counter; });
+	threadPool.Wait();
+	REQUIRE(counter == 1001);
+}
+
+TEST_CASE("thread pool never starts without a worker", "[thread_pool]") {
+	ThreadPool threadPool(0);
+	REQUIRE(threadPool.GetThreadCount() == 1);
+
+	bool done = false;
+	threadPool.Submit([&done] { done = true; });
+	threadPool.Wait();
+	REQUIRE(done);
+}
@@ -0,0 +1,72 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/trace.hpp>
+
+#include <fstream>
+#include <sstream>
+
+using plugify::TraceSystem;
+
+namespace {
+	std::string ReadFile(const std::filesystem::path& path) {
+		std::ifstream is(path, std::ios::binary);
+		std::stringstream ss;
+		ss << is.rdbuf();
+		return ss.str();
+	}
+}
+
+TEST_CASE("trace > chrome trace file", "[trace]") {
+	const auto path = std::filesystem::temp_directory_path() / "plugify_trace_test.json";
+
+	SECTION("disabled") {
+		TraceSystem::SetEnabled(false);
+		{
+			PL_TRACE_SCOPE("OnPluginLoad", "plugin", "sample_plugin");
+		}
+		REQUIRE_FALSE(TraceSystem::Write(path));
+	}
+
+	SECTION("spans per thread") {
+		TraceSystem::SetEnabled(true);
+		{
+			PL_TRACE_SCOPE("OnPluginLoad", "plugin", "sample_plugin");
+		}
+		std::thread([] {
+			PL_TRACE_SCOPE("OnPluginStart", "plugin", "other_plugin");
+		}).join();
+		REQUIRE(TraceSystem::Write(path));
+		TraceSystem::SetEnabled(false);
+
+		const auto json = ReadFile(path);
+		std::filesystem::remove(path);
+
+		CHECK(json.find(R"("traceEvents":[)") != std::string::npos);
+		CHECK(json.find(R"("name":"OnPluginLoad","cat":"plugin","ph":"X")") != std::string::npos);
+		CHECK(json.find(R"("name":"OnPluginStart","cat":"plugin","ph":"X")") != std::string::npos);
+		CHECK(json.find(R"("args":{"target":"sample_plugin"})") != std::string::npos);
+		CHECK(json.find(R"("tid":0)") != std::string::npos);
+		CHECK(json.find(R"("tid":1)") != std::string::npos);
+		CHECK(json.find(R"("name":"thread_name")") != std::string::npos);
+	}
+
+	SECTION("main thread keeps id 0 when a worker records first") {
+		TraceSystem::SetEnabled(true);
+		std::thread([] {
+			PL_TRACE_SCOPE("OnPluginStart", "plugin", "other_plugin");
+		}).join();
+		{
+			PL_TRACE_SCOPE("OnPluginLoad", "plugin", "sample_plugin");
+		}
+		REQUIRE(TraceSystem::Write(path));
+		TraceSystem::SetEnabled(false);
+
+		const auto json = ReadFile(path);
+		std::filesystem::remove(path);
+
+		CHECK(json.find(R"("tid":1,"args":{"target":"other_plugin"})") != std::string::npos);
+		CHECK(json.find(R"("tid":0,"args":{"target":"sample_plugin"})") != std::string::npos);
+		CHECK(json.find(R"("tid":0,"args":{"name":"Main"})") != std::string::npos);
+		CHECK(json.find(R"("tid":1,"args":{"name":"Worker 1"})") != std::string::npos);
+	}
+}
@@ -0,0 +1,73 @@
+#include <catch_amalgamated.hpp>
+
+#include <utils/vtable_index.hpp>
+
+#include <cstring>
+#include <vector>
+
+using plugify::VirtualTableIndex;
+
+namespace {
+	// Itanium layout, built by hand: typeinfos {vptr, name*}, tables {offset-to-top, typeinfo*, functions...}
+	struct Module {
+		std::vector<uint8_t> names;
+		std::vector<uintptr_t> tables;
+
+		size_t AddName(const char* name) {
+			const size_t offset = names.size();
+			names.insert(names.end(), name, name + std::strlen(name) + 1);
+			return offset;
+		}
+
+		VirtualTableIndex Build() const {
+			const std::span<const uint8_t> sections[] = { std::span(reinterpret_cast<const uint8_t*>(tables.data()), tables.size() * sizeof(uintptr_t)) };
+			return VirtualTableIndex::FromItanium(names, sections);
+		}
+
+		uintptr_t GetAddress(size_t slot) const {
+			return reinterpret_cast<uintptr_t>(&tables[slot]);
+		}
+	};
+}
+
+TEST_CASE("virtual table index maps names to tables", "[vtable_index]") {
+	Module module;
+	const size_t fooName = module.AddName("3Foo");
+	const size_t barName = module.AddName("*N2ns3BarE");
+	const size_t badName = module.AddName("not a type");
+
+	// Enough slots so no pointer moves after it is taken
+	module.tables.resize(32);
+	auto name = [&](size_t offset) { return reinterpret_cast<uintptr_t>(module.names.data() + offset); };
+
+	// Typeinfos at slots 0, 2 and 4
+	module.tables[0] = 1; module.tables[1] = name(fooName);
+	module.tables[2] = 1; module.tables[3] = name(barName);
+	module.tables[4] = 1; module.tables[5] = name(badName);
+
+	// Foo: a secondary table with a non-zero offset-to-top comes first and is skipped
+	module.tables[6] = static_cast<uintptr_t>(-8); module.tables[7] = module.GetAddress(0); module.tables[8] = 0x1000;
+	module.tables[9] = 0; module.tables[10] = module.GetAddress(0); module.tables[11] = 0x1000;
+	// Bar, with a '*' before the name which is not part of the mangling
+	module.tables[12] = 0; module.tables[13] = module.GetAddress(2); module.tables[14] = 0x2000;
+	// A second table for Bar, the first one wins
+	module.tables[15] = 0; module.tables[16] = module.GetAddress(2); module.tables[17] = 0x2000;
+	// A name which is no mangled type
+	module.tables[18] = 0; module.tables[19] = module.GetAddress(4); module.tables[20] = 0x3000;
+	// A typeinfo pointer outside of the sections
+	module.tables[21] = 0; module.tables[22] = 0x10; module.tables[23] = 0x4000;
+
+	auto index = module.Build();
+	REQUIRE(index.GetCount() == 2);
+	REQUIRE(index.Find("3Foo") == module.GetAddress(11));
+	REQUIRE(index.Find("N2ns3BarE") == module.GetAddress(14));
+	REQUIRE(index.Find("*N2ns3BarE") == 0);
+	REQUIRE(index.Find("not a type") == 0);
+	REQUIRE(index.Find("3Baz") == 0);
+}
+
+TEST_CASE("virtual table index of empty sections", "[vtable_index]") {
+	auto index = VirtualTableIndex::FromItanium({}, {});
+	REQUIRE(index.GetCount() == 0);
+	REQUIRE(index.Find("3Foo") == 0);
+}